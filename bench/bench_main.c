@@ -0,0 +1,628 @@
+/**
+ * @file bench_main.c
+ * @brief Host Micro-Benchmarks for the Secure Boot Modules
+ * 
+ * Runs each module's hot entry point against the mock peripheral layer
+ * and prints one JSON object per benchmark (JSON Lines) on stdout.
+ * Every benchmark reseeds the mock TRNG, runs a warm-up batch, then
+ * BENCH_REPEATS timed batches; the median batch is the headline figure.
+ * 
+ * Usage: bench [filter]   (only benchmarks whose name contains filter)
+ */
+
+#include "secure_boot.h"
+#include "anti_rollback.h"
+#include "attestation.h"
+#include "ecdsa_p256.h"
+#include "entropy_pool.h"
+#include "image_hash.h"
+#include "image_lz4.h"
+#include "image_merkle.h"
+#include "jitter.h"
+#include "puf.h"
+#include "secure_gateway.h"
+#include "sha256.h"
+#include "tamper_detection.h"
+#include "trustzone.h"
+#include "verify_cache.h"
+#include "warm_resume.h"
+#include "zeroize.h"
+#include "mock_periph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Timed batches per benchmark (odd, for a true median) */
+#define BENCH_REPEATS       7
+
+/* Fixed TRNG seed so jitter draws repeat run to run */
+#define BENCH_TRNG_SEED     0xB5E7C0DEu
+
+/* Benchmark payload sizes */
+#define BENCH_IMAGE_SIZE    (16 * 1024)
+#define BENCH_ZEROIZE_SIZE  (4 * 1024)
+#define BENCH_EVENT_COUNT   32
+
+/* Compressed image: 4KB blocks, 16 literals + 48-byte match per 64 bytes */
+#define BENCH_LZ4_BLOCK_LOG2    12
+#define BENCH_LZ4_OFFSET        256     /* Period of the bench image pattern */
+
+/* Segmented image: 4KB segments, so the default entry point's segment and
+ * a later one fault in separately */
+#define BENCH_MERKLE_LOG2       12
+#define BENCH_MERKLE_SEGMENTS   (BENCH_IMAGE_SIZE >> BENCH_MERKLE_LOG2)
+#define BENCH_MERKLE_DATA       (sizeof(firmware_header_t) + sizeof(image_merkle_ext_t) + \
+                                 BENCH_MERKLE_SEGMENTS * SHA256_DIGEST_SIZE)
+
+/* One benchmark: op runs the measured operation once */
+typedef struct {
+    const char *name;
+    void (*setup)(void);
+    void (*op)(void);
+    uint32_t iterations;         /* Operations per timed batch */
+    uint32_t bytes;              /* Bytes processed per operation, or 0 */
+} bench_case_t;
+
+/* Shared fixtures */
+static boot_context_t g_bench_context;
+static attestation_report_t g_bench_report;
+static tamper_context_t g_bench_tamper;
+static uint8_t g_bench_image[BENCH_IMAGE_SIZE] __attribute__((aligned(4)));
+static uint8_t g_bench_scratch[BENCH_ZEROIZE_SIZE] __attribute__((aligned(4)));
+static uint8_t g_bench_lz4[sizeof(image_lz4_ext_t) + BENCH_IMAGE_SIZE] __attribute__((aligned(4)));
+static uint8_t g_bench_lz4_out[BENCH_IMAGE_SIZE] __attribute__((aligned(4)));
+static uint8_t g_bench_merkle_slot[BENCH_MERKLE_DATA + BENCH_IMAGE_SIZE] __attribute__((aligned(4)));
+static char g_bench_json[8192];
+static uint8_t g_bench_cbor[4096];
+static uint8_t g_bench_key[32];
+static attestation_ack_t g_bench_ack;
+static firmware_header_t g_bench_header;
+static firmware_header_t g_bench_resume_header;  /* Above the OTP floor, as a booted image is */
+static uint32_t g_bench_probe = 0;
+
+/* Digest and signature under the development root key (config/root_pubkey.hex) */
+static const uint8_t k_bench_sig_hash[32] = {
+    0x65, 0x9C, 0xC0, 0x5D, 0xBF, 0x85, 0xED, 0x83, 0xD0, 0xA9, 0x82, 0x27,
+    0x91, 0x30, 0x06, 0x04, 0x0C, 0xBA, 0x48, 0xF8, 0x04, 0x2D, 0x65, 0x49,
+    0x0E, 0x24, 0x4C, 0x4E, 0x87, 0x79, 0x0E, 0x66
+};
+static const uint8_t k_bench_signature[64] = {
+    0x80, 0x1E, 0xE2, 0x95, 0xC2, 0x8B, 0x7C, 0xC8, 0xFB, 0xED, 0x16, 0x62,
+    0xD2, 0x21, 0x23, 0xBB, 0x3E, 0xC6, 0x28, 0x46, 0x91, 0x09, 0x04, 0x1E,
+    0xE3, 0xBC, 0x01, 0x2B, 0x0D, 0xCC, 0x0E, 0x2B, 0x5C, 0x7E, 0x2F, 0xAD,
+    0x6C, 0x4F, 0x5E, 0x18, 0xAD, 0x19, 0x09, 0x3B, 0x43, 0x1E, 0x56, 0x1B,
+    0x0B, 0xE6, 0x7C, 0x0D, 0xA8, 0x03, 0xDF, 0x49, 0x72, 0xFF, 0x97, 0xA7,
+    0x04, 0x9C, 0xAD, 0xBF
+};
+
+/* Sink for results the compiler must not discard */
+static volatile uint32_t g_bench_sink;
+
+/* Non-Secure buffer for the gateway benchmark */
+static uint8_t *g_bench_ns_buffer;
+
+/* Host memory map: Secure below 0x20008000, Non-Secure RAM above */
+#define BENCH_NS_FLASH_START    0x00040000
+#define BENCH_NS_FLASH_END      0x00100000
+#define BENCH_NS_RAM_START      0x20008000
+#define BENCH_NS_RAM_END        0x20020000
+
+static const sau_region_words_t bench_sau_words[] = {
+    SAU_REGION_WORDS(0, BENCH_NS_FLASH_START, BENCH_NS_FLASH_END, false),
+    SAU_REGION_WORDS(1, BENCH_NS_RAM_START, BENCH_NS_RAM_END, false)
+};
+
+/* Every region must fit the warm-resume snapshot, or sealing always fails */
+typedef char bench_sau_fits_resume[WARM_RESUME_SAU_FITS(bench_sau_words) ? 1 : -1];
+
+static const trustzone_config_t bench_tz_config = {
+    .flash_secure = { 0x00000000, 0x00040000, REGION_TYPE_SECURE, true },
+    .flash_non_secure = { BENCH_NS_FLASH_START, BENCH_NS_FLASH_END, REGION_TYPE_NON_SECURE, true },
+    .ram_secure = { 0x20000000, 0x20008000, REGION_TYPE_SECURE, true },
+    .ram_non_secure = { BENCH_NS_RAM_START, BENCH_NS_RAM_END, REGION_TYPE_NON_SECURE, true },
+    .peripheral_secure = { 0x40000000, 0x50000000, REGION_TYPE_SECURE, true },
+    .gateway_count = 0,
+    .sau_words = bench_sau_words,
+    .sau_word_count = sizeof(bench_sau_words) / sizeof(bench_sau_words[0])
+};
+
+/**
+ * @brief Monotonic time in nanoseconds
+ */
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* ---- Operations ---- */
+
+static void setup_tokens_factory(void) {
+    jitter_set_profile(JITTER_PROFILE_FACTORY);
+}
+
+static void setup_tokens_field(void) {
+    jitter_set_profile(JITTER_PROFILE_FIELD);
+}
+
+static void op_verify_layered_tokens(void) {
+    /* Each iteration is one boot's worth of jitter budget */
+    jitter_budget_reset();
+    g_bench_sink = verify_layered_tokens(&g_bench_context);
+}
+
+static void op_check_anti_rollback(void) {
+    jitter_budget_reset();
+    g_bench_sink = check_anti_rollback(0x01000000, 0);
+}
+
+static void op_read_otp_counter(void) {
+    uint32_t value = 0;
+    read_otp_counter(g_bench_probe++ % MAX_OTP_COUNTERS, &value);
+    g_bench_sink = value;
+}
+
+static void op_image_hash(void) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    image_hash_compute(g_bench_image, sizeof(g_bench_image), IMAGE_HASH_BACKEND_CPU, digest);
+    g_bench_sink = digest[0];
+}
+
+static void op_image_hash_se(void) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    image_hash_compute(g_bench_image, sizeof(g_bench_image), IMAGE_HASH_BACKEND_SE_PIPELINED, digest);
+    g_bench_sink = digest[0];
+}
+
+static void op_image_lz4_decompress(void) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    image_lz4_decompress((const image_lz4_ext_t *)g_bench_lz4, g_bench_lz4_out, BENCH_IMAGE_SIZE,
+                         IMAGE_HASH_BACKEND_CPU, digest);
+    g_bench_sink = digest[0];
+}
+
+static void op_image_lz4_decompress_se(void) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    image_lz4_decompress((const image_lz4_ext_t *)g_bench_lz4, g_bench_lz4_out, BENCH_IMAGE_SIZE,
+                         IMAGE_HASH_BACKEND_SE_PIPELINED, digest);
+    g_bench_sink = digest[0];
+}
+
+static void setup_verify_cache_rehash(void) {
+    verify_cache_store(&g_bench_header, VERIFY_CACHE_MODE_REHASH);
+}
+
+static void op_verify_cache_rehash(void) {
+    g_bench_sink = verify_cache_check(&g_bench_header, g_bench_image, VERIFY_CACHE_MODE_REHASH);
+}
+
+static void setup_verify_cache_merkle(void) {
+    verify_cache_store((const firmware_header_t *)g_bench_merkle_slot, VERIFY_CACHE_MODE_WRITE_LOCK);
+}
+
+static void op_verify_cache_merkle(void) {
+    const firmware_header_t *header = (const firmware_header_t *)g_bench_merkle_slot;
+    
+    /* As on a boot cache hit: leaf table armed, boot segments opened */
+    g_bench_sink = verify_cache_check(header, (const uint8_t *)(header + 1),
+                                      VERIFY_CACHE_MODE_WRITE_LOCK);
+    g_bench_sink ^= image_merkle_verify_boot_segments(header);
+}
+
+static void setup_warm_resume(void) {
+    boot_context_t booted;
+    
+    /* Stands in for the full boot, which reads the fixed flash slot */
+    memset(&booted, 0, sizeof(booted));
+    booted.verification_tokens[0] = TOKEN_LAYER_1;
+    booted.verification_tokens[1] = TOKEN_LAYER_2;
+    booted.verification_tokens[2] = TOKEN_LAYER_3;
+    booted.verification_tokens[3] = TOKEN_LAYER_4;
+    booted.status = BOOT_STATUS_SUCCESS;
+    
+    verify_cache_store(&g_bench_resume_header, VERIFY_CACHE_DEFAULT_MODE);
+    (void)secure_boot_resume(&booted, &g_bench_resume_header, g_bench_image);
+}
+
+static void op_warm_resume(void) {
+    warm_resume_enter_em4(&g_bench_resume_header);
+    g_bench_sink = warm_resume_restore(&bench_tz_config, &g_bench_resume_header, g_bench_image);
+}
+
+static void op_ecdsa_verify_sw(void) {
+    g_bench_sink = ecdsa_p256_verify(ECDSA_BACKEND_SW_COMB, k_bench_sig_hash, k_bench_signature);
+}
+
+static void op_ecdsa_verify_se(void) {
+    g_bench_sink = ecdsa_p256_verify(ECDSA_BACKEND_SE, k_bench_sig_hash, k_bench_signature);
+}
+
+static void op_sha256(void) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_compute(g_bench_image, sizeof(g_bench_image), digest);
+    g_bench_sink = digest[0];
+}
+
+static void setup_puf_closed(void) {
+    puf_session_close();
+}
+
+static void setup_puf_session(void) {
+    puf_session_open();
+}
+
+static void op_puf_derive_key(void) {
+    static const uint8_t context[] = "bench-derive";
+    puf_derive_key(context, sizeof(context) - 1, g_bench_key, sizeof(g_bench_key));
+    g_bench_sink = g_bench_key[0];
+}
+
+static void op_attestation_challenge(void) {
+    static const uint8_t nonce[NONCE_SIZE] = { 0x24 };
+    attestation_view_t view;
+    
+    attestation_snapshot(nonce, &view);
+    g_bench_sink = sign_attestation_view(&view);
+}
+
+static void op_export_report_json(void) {
+    g_bench_sink = export_report_json(&g_bench_report, g_bench_json, sizeof(g_bench_json));
+}
+
+static void op_export_report_cbor(void) {
+    g_bench_sink = export_report_cbor(&g_bench_report, g_bench_cbor, sizeof(g_bench_cbor));
+}
+
+static void setup_report_cbor_delta(void) {
+    /* Verifier holds every measurement and all but the last 4 events */
+    memcpy(g_bench_ack.measurement_digest, g_bench_report.measurement_digest,
+           sizeof(g_bench_ack.measurement_digest));
+    g_bench_ack.event_sequence = g_bench_report.event_digest_sequence - 4;
+}
+
+static void op_export_report_cbor_delta(void) {
+    g_bench_sink = export_report_cbor_delta(&g_bench_report, &g_bench_ack, g_bench_cbor, sizeof(g_bench_cbor));
+}
+
+static void op_add_event_log_entry(void) {
+    g_bench_sink = add_event_log_entry_id(0x30, g_bench_probe++, EVENT_STRING_NONE, NULL, 0);
+}
+
+static void op_check_tamper_events(void) {
+    g_bench_sink = check_tamper_events(&g_bench_tamper);
+}
+
+static void op_tamper_supply_block(void) {
+    /* One half-buffer completion from the supply scan (LDMA channel 1) */
+    g_mock_periph.ldma_if = 1UL << 1;
+    iadc_dma_irq_handler();
+}
+
+static void op_is_address_secure(void) {
+    /* Walk Secure flash, NS flash, Secure RAM, NS RAM and peripherals */
+    static const uint32_t probes[] = {
+        0x00001000, 0x00080000, 0x20004000, 0x20010000, 0x40001000, 0x30000000
+    };
+    g_bench_sink = is_address_secure(probes[g_bench_probe++ % 6]);
+}
+
+static void op_is_range_secure(void) {
+    g_bench_sink = is_range_secure(BENCH_NS_RAM_START + 0x100, 256);
+}
+
+static int32_t bench_gateway_handler(void *buffer, uint32_t length, uint32_t arg) {
+    (void)buffer;
+    return (int32_t)(length + arg);
+}
+
+static void setup_gateway(void) {
+    static const secure_gateway_t gateway = { 0, 1, bench_gateway_handler, true };
+    
+    secure_gateway_reset();
+    secure_gateway_bind(&gateway);
+    g_bench_ns_buffer = (uint8_t *)(uintptr_t)(BENCH_NS_RAM_START + 0x200);
+}
+
+static void op_secure_gateway_call(void) {
+    /* Buffer is validated, never dereferenced by the handler */
+    g_bench_sink = (uint32_t)secure_gateway_call(1, g_bench_ns_buffer, 64, 0);
+}
+
+static void op_entropy_pool_get_word(void) {
+    g_bench_sink = entropy_pool_get_word();
+}
+
+static void op_zeroize_region(void) {
+    g_bench_sink = zeroize_region(g_bench_scratch, sizeof(g_bench_scratch));
+}
+
+static void op_zeroize_fast(void) {
+    zeroize_fast(g_bench_key, sizeof(g_bench_key));
+}
+
+static const bench_case_t k_bench_cases[] = {
+    { "verify_layered_tokens/factory", setup_tokens_factory, op_verify_layered_tokens, 200, 0 },
+    { "verify_layered_tokens/field", setup_tokens_field, op_verify_layered_tokens, 20, 0 },
+    { "check_anti_rollback", setup_tokens_factory, op_check_anti_rollback, 200, 0 },
+    { "read_otp_counter", NULL, op_read_otp_counter, 100000, 0 },
+    { "image_hash_compute/cpu", NULL, op_image_hash, 200, BENCH_IMAGE_SIZE },
+    { "image_hash_compute/se", NULL, op_image_hash_se, 200, BENCH_IMAGE_SIZE },
+    { "image_lz4_decompress/cpu", NULL, op_image_lz4_decompress, 200, BENCH_IMAGE_SIZE },
+    { "image_lz4_decompress/se", NULL, op_image_lz4_decompress_se, 200, BENCH_IMAGE_SIZE },
+    { "verify_cache_check/rehash", setup_verify_cache_rehash, op_verify_cache_rehash, 200, 0 },
+    { "verify_cache_check/write_lock_merkle", setup_verify_cache_merkle, op_verify_cache_merkle, 200, 0 },
+    { "warm_resume_restore", setup_warm_resume, op_warm_resume, 200, BENCH_IMAGE_SIZE },
+    { "ecdsa_p256_verify/sw_comb", NULL, op_ecdsa_verify_sw, 200, 0 },
+    { "ecdsa_p256_verify/se", NULL, op_ecdsa_verify_se, 200, 0 },
+    { "sha256_compute", NULL, op_sha256, 200, BENCH_IMAGE_SIZE },
+    { "puf_derive_key/reconstruct", setup_puf_closed, op_puf_derive_key, 20000, 0 },
+    { "puf_derive_key/session", setup_puf_session, op_puf_derive_key, 100000, 0 },
+    { "attestation_challenge", NULL, op_attestation_challenge, 20000, 0 },
+    { "export_report_json", NULL, op_export_report_json, 2000, 0 },
+    { "export_report_cbor", NULL, op_export_report_cbor, 5000, 0 },
+    { "export_report_cbor_delta", setup_report_cbor_delta, op_export_report_cbor_delta, 5000, 0 },
+    { "add_event_log_entry_id", NULL, op_add_event_log_entry, 100000, 0 },
+    { "check_tamper_events", NULL, op_check_tamper_events, 100000, 0 },
+    { "iadc_dma_irq_handler", NULL, op_tamper_supply_block, 20000, 0 },
+    { "is_address_secure", NULL, op_is_address_secure, 100000, 0 },
+    { "is_range_secure", NULL, op_is_range_secure, 100000, 0 },
+    { "secure_gateway_call", setup_gateway, op_secure_gateway_call, 100000, 0 },
+    { "entropy_pool_get_word", NULL, op_entropy_pool_get_word, 100000, 0 },
+    { "zeroize_region/4k", NULL, op_zeroize_region, 5000, BENCH_ZEROIZE_SIZE },
+    { "zeroize_fast/32", NULL, op_zeroize_fast, 100000, 32 }
+};
+
+/**
+ * @brief Emit one LZ4 length extension
+ */
+static uint8_t *bench_lz4_length(uint8_t *p, uint32_t n) {
+    while (n >= 255) {
+        *p++ = 255;
+        n -= 255;
+    }
+    *p++ = (uint8_t)n;
+    return p;
+}
+
+/**
+ * @brief Emit one LZ4 sequence: lit bytes of the image at pos, then a match
+ */
+static uint8_t *bench_lz4_sequence(uint8_t *p, uint32_t pos, uint32_t lit, uint32_t match) {
+    uint8_t *token = p++;
+    
+    *token = (uint8_t)((lit < 15 ? lit : 15) << 4);
+    if (lit >= 15) {
+        p = bench_lz4_length(p, lit - 15);
+    }
+    memcpy(p, &g_bench_image[pos], lit);
+    p += lit;
+    
+    if (match != 0) {
+        *token |= (uint8_t)(match - 4 < 15 ? match - 4 : 15);
+        *p++ = (uint8_t)BENCH_LZ4_OFFSET;
+        *p++ = (uint8_t)(BENCH_LZ4_OFFSET >> 8);
+        if (match - 4 >= 15) {
+            p = bench_lz4_length(p, match - 4 - 15);
+        }
+    }
+    return p;
+}
+
+/**
+ * @brief Build the LZ4 block stream of g_bench_image
+ */
+static void bench_build_lz4(void) {
+    image_lz4_ext_t *ext = (image_lz4_ext_t *)g_bench_lz4;
+    uint8_t *start = g_bench_lz4 + sizeof(image_lz4_ext_t);
+    uint8_t *p = start;
+    uint32_t block = 1UL << BENCH_LZ4_BLOCK_LOG2;
+    
+    for (uint32_t pos = 0; pos < BENCH_IMAGE_SIZE; pos += block) {
+        uint8_t *record = p;
+        uint32_t i = 0;
+        
+        p += sizeof(uint32_t);
+        while (block - i > 80) {
+            /* Literals until a full offset of output exists */
+            uint32_t lit = 16;
+            if (pos + i + lit < BENCH_LZ4_OFFSET) {
+                lit = BENCH_LZ4_OFFSET - (pos + i);
+            }
+            p = bench_lz4_sequence(p, pos + i, lit, 48);
+            i += lit + 48;
+        }
+        p = bench_lz4_sequence(p, pos + i, block - i, 0);
+        
+        uint32_t len = (uint32_t)(p - record) - sizeof(uint32_t);
+        memcpy(record, &len, sizeof(len));
+    }
+    
+    ext->block_log2 = BENCH_LZ4_BLOCK_LOG2;
+    ext->compressed_size = (uint32_t)(p - start);
+}
+
+/**
+ * @brief Build a Merkle slot of g_bench_image, executing in place
+ * @return true if the slot arms and opens its segments on a WRITE_LOCK cache hit
+ */
+static bool bench_build_merkle(void) {
+    static const uint8_t prefix = IMAGE_MERKLE_LEAF_PREFIX;
+    firmware_header_t *header = (firmware_header_t *)g_bench_merkle_slot;
+    image_merkle_ext_t *ext = (image_merkle_ext_t *)(header + 1);
+    uint8_t *leaves = (uint8_t *)(ext + 1);
+    uint8_t *data = g_bench_merkle_slot + BENCH_MERKLE_DATA;
+    uint32_t segment = 1UL << BENCH_MERKLE_LOG2;
+    sha256_context_t ctx;
+    
+    memcpy(data, g_bench_image, BENCH_IMAGE_SIZE);
+    ext->segment_log2 = BENCH_MERKLE_LOG2;
+    ext->segment_count = BENCH_MERKLE_SEGMENTS;
+    for (uint32_t i = 0; i < BENCH_MERKLE_SEGMENTS; i++) {
+        uint8_t index_le[4] = { (uint8_t)i, (uint8_t)(i >> 8), (uint8_t)(i >> 16), (uint8_t)(i >> 24) };
+        sha256_init(&ctx);
+        sha256_update(&ctx, &prefix, 1);
+        sha256_update(&ctx, index_le, sizeof(index_le));
+        sha256_update(&ctx, data + i * segment, segment);
+        sha256_final(&ctx, &leaves[i * SHA256_DIGEST_SIZE]);
+    }
+    
+    *header = g_bench_header;
+    header->flags = FIRMWARE_FLAG_MERKLE;
+    header->load_address = (uint32_t)(uintptr_t)data;
+    header->entry_point = header->load_address + 4;
+    if (!firmware_image_digest(header, (const uint8_t *)ext, header->hash)) {
+        return false;
+    }
+    
+    /* Page locks index from the page holding the slot */
+    g_mock_periph.flash_base = (uintptr_t)g_bench_merkle_slot & ~(uintptr_t)(VERIFY_CACHE_PAGE_SIZE - 1);
+    if (!verify_cache_needs_digest(header, VERIFY_CACHE_MODE_WRITE_LOCK) ||
+        !verify_cache_store(header, VERIFY_CACHE_MODE_WRITE_LOCK) ||
+        verify_cache_check(header, (const uint8_t *)ext, VERIFY_CACHE_MODE_WRITE_LOCK) !=
+            TOKEN_STATE_ALL_VALID) {
+        return false;
+    }
+    
+    /* The hit re-armed the leaf table: boot segments open, the last one
+     * resolves on its first access fault */
+    return image_merkle_verify_boot_segments(header) &&
+           image_merkle_fault_handler(header->load_address + (BENCH_MERKLE_SEGMENTS - 1) * segment);
+}
+
+/**
+ * @brief Bring up every module once against a freshly reset mock
+ */
+static bool bench_init(void) {
+    mock_periph_reset(BENCH_TRNG_SEED);
+    
+    if (!entropy_pool_init() || !anti_rollback_init() || !attestation_init() ||
+        !trustzone_init(&bench_tz_config) || !puf_init() || !puf_enroll()) {
+        return false;
+    }
+    
+    static const acmp_config_t acmp = { 1800, 3600, 50, true };
+    static const iadc_config_t iadc = { 1000, (uint32_t)-20, 85, true, true };
+    if (!acmp_init(&acmp) || !iadc_init(&iadc) || !tamper_detection_start(&g_bench_tamper)) {
+        return false;
+    }
+    
+    g_bench_context.verification_tokens[0] = TOKEN_LAYER_1;
+    g_bench_context.verification_tokens[1] = TOKEN_LAYER_2;
+    g_bench_context.verification_tokens[2] = TOKEN_LAYER_3;
+    g_bench_context.verification_tokens[3] = TOKEN_LAYER_4;
+    
+    for (uint32_t i = 0; i < sizeof(g_bench_image); i++) {
+        g_bench_image[i] = (uint8_t)(i * 31U + 7U);
+    }
+    
+    g_bench_header.magic = FIRMWARE_IMAGE_MAGIC;
+    g_bench_header.version = 0x01000000;
+    g_bench_header.image_size = sizeof(g_bench_image);
+    sha256_compute(g_bench_image, sizeof(g_bench_image), g_bench_header.hash);
+    
+    /* The compressed stream must decode to the same image */
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    bench_build_lz4();
+    if (!image_lz4_decompress((const image_lz4_ext_t *)g_bench_lz4, g_bench_lz4_out,
+                              BENCH_IMAGE_SIZE, IMAGE_HASH_BACKEND_CPU, digest) ||
+        memcmp(digest, g_bench_header.hash, sizeof(digest)) != 0) {
+        return false;
+    }
+    
+    if (!bench_build_merkle()) {
+        return false;
+    }
+    
+    /* Seal -> EM4 -> restore must take the warm path, not the full boot */
+    g_bench_resume_header = g_bench_header;
+    g_bench_resume_header.version = 0x01000001;
+    setup_warm_resume();
+    op_warm_resume();
+    if (g_bench_sink != TOKEN_STATE_ALL_VALID) {
+        return false;
+    }
+    
+    /* Representative report: measurements plus a populated event log */
+    uint8_t measurement[32];
+    for (uint32_t c = 0; c < 4; c++) {
+        memset(measurement, (int)(0x10 + c), sizeof(measurement));
+        add_boot_measurement(c, measurement, 0);
+    }
+    for (uint32_t i = 0; i < BENCH_EVENT_COUNT; i++) {
+        add_event_log_entry(0x40, i, "bench event");
+    }
+    
+    static const uint8_t nonce[32] = { 0x42 };
+    return generate_attestation_report(nonce, &g_bench_report);
+}
+
+/**
+ * @brief Run one benchmark and print its JSON record
+ */
+static void bench_run(const bench_case_t *bc) {
+    uint64_t batch_ns[BENCH_REPEATS];
+    
+    /* Same TRNG stream for every benchmark and every run */
+    g_mock_periph.trng_state = BENCH_TRNG_SEED;
+    g_bench_probe = 0;
+    
+    if (bc->setup != NULL) {
+        bc->setup();
+    }
+    
+    /* Warm-up: caches, branch predictors, lazy init */
+    for (uint32_t i = 0; i < bc->iterations; i++) {
+        bc->op();
+    }
+    
+    for (uint32_t r = 0; r < BENCH_REPEATS; r++) {
+        uint64_t start = bench_now_ns();
+        for (uint32_t i = 0; i < bc->iterations; i++) {
+            bc->op();
+        }
+        batch_ns[r] = bench_now_ns() - start;
+    }
+    
+    qsort(batch_ns, BENCH_REPEATS, sizeof(batch_ns[0]), bench_cmp_u64);
+    
+    double n = (double)bc->iterations;
+    double median = (double)batch_ns[BENCH_REPEATS / 2] / n;
+    
+    printf("{\"bench\":\"%s\",\"iterations\":%u,\"repeats\":%d,"
+           "\"ns_per_op\":%.1f,\"ns_per_op_min\":%.1f,\"ns_per_op_max\":%.1f",
+           bc->name, (unsigned)bc->iterations, BENCH_REPEATS, median,
+           (double)batch_ns[0] / n, (double)batch_ns[BENCH_REPEATS - 1] / n);
+    
+    if (bc->bytes != 0) {
+        printf(",\"mb_per_s\":%.1f", (double)bc->bytes * 1000.0 / median);
+    }
+    
+    printf("}\n");
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    const char *filter = (argc > 1) ? argv[1] : NULL;
+    
+    if (!bench_init()) {
+        fprintf(stderr, "bench: module initialization failed\n");
+        return 1;
+    }
+    
+    for (size_t i = 0; i < sizeof(k_bench_cases) / sizeof(k_bench_cases[0]); i++) {
+        if (filter == NULL || strstr(k_bench_cases[i].name, filter) != NULL) {
+            bench_run(&k_bench_cases[i]);
+        }
+    }
+    
+    puf_session_zeroize();
+    
+    return 0;
+}
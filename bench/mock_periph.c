@@ -0,0 +1,49 @@
+/**
+ * @file mock_periph.c
+ * @brief Mock Peripheral Layer Implementation
+ */
+
+#include "mock_periph.h"
+#include "secure_boot.h"
+#include <string.h>
+
+mock_periph_t g_mock_periph;
+
+/**
+ * @brief Reset all mock peripherals to their idle, freshly provisioned state
+ */
+void mock_periph_reset(uint32_t trng_seed) {
+    memset(&g_mock_periph, 0, sizeof(g_mock_periph));
+    
+    g_mock_periph.trng_state = (trng_seed != 0) ? trng_seed : 0x6C8E9CF5u;
+    
+    /* Provisioned with the build's firmware version, counters unprogrammed */
+    g_mock_periph.otp_version.major = FIRMWARE_VERSION_MAJOR;
+    g_mock_periph.otp_version.minor = FIRMWARE_VERSION_MINOR;
+    g_mock_periph.otp_version.patch = FIRMWARE_VERSION_PATCH;
+    
+    /* Secure Vault up */
+    g_mock_periph.semailbox_status = MOCK_SEMAILBOX_STATUS_READY;
+    g_mock_periph.se_puf_polls = MOCK_SE_PUF_RECONSTRUCT_POLLS;
+    
+    /* Supply inside the window, die at nominal temperature */
+    g_mock_periph.acmp0_status = MOCK_ACMP_STATUS_ACMPOUT;
+    g_mock_periph.acmp1_status = 0;
+    g_mock_periph.iadc0_singlefifodata = MOCK_IADC_TEMP_CODE_25C;
+}
+
+/**
+ * @brief Read one TRNG FIFO word
+ */
+uint32_t mock_trng_read(void) {
+    uint32_t x = g_mock_periph.trng_state;
+    
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    
+    g_mock_periph.trng_state = x;
+    g_mock_periph.trng_reads++;
+    
+    return x;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file mock_periph.h
+ * @brief Mock Peripheral Layer for Host Builds
+ * 
+ * Backs the simulated OTP, TRNG, SE mailbox and ACMP/IADC registers with
+ * one shared, resettable block when the sources are built with
+ * -DSIM_PERIPH_MOCK. Drivers keep their register names; only the storage
+ * moves here, so the benchmark can seed and drive it between runs.
+ */
+
+#ifndef MOCK_PERIPH_H
+#define MOCK_PERIPH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "anti_rollback.h"
+
+/* Register bits the mock models (EFR32 Series 2 layout) */
+#define MOCK_ACMP_STATUS_ACMPOUT    (1UL << 2)
+#define MOCK_SEMAILBOX_STATUS_READY (1UL << 0)
+#define MOCK_IADC_STATUS_SINGLEFIFODV (1UL << 8)
+#define MOCK_IADC_TEMP_CODE_25C     1700
+
+/* RX_STATUS polls before the SE answers a PUF key reconstruction */
+#define MOCK_SE_PUF_RECONSTRUCT_POLLS 20000
+
+/* Mock Peripheral State */
+typedef struct {
+    /* TRNG0: xorshift32 output, seeded for repeatable runs */
+    uint32_t trng_state;
+    uint32_t trng_reads;
+    
+    /* OTP counter/version block */
+    uint32_t otp_counters[MAX_OTP_COUNTERS][OTP_COUNTER_WORDS];
+    version_t otp_version;
+    
+    /* SEMAILBOX */
+    volatile uint32_t semailbox_busy;
+    volatile uint32_t semailbox_status;
+    uint32_t se_puf_polls;          /* Modeled PUF reconstruction latency */
+    
+    /* ACMP0 (undervoltage), ACMP1 (overvoltage), IADC0, LDMA */
+    volatile uint32_t acmp0_if;
+    volatile uint32_t acmp0_status;
+    volatile uint32_t acmp1_if;
+    volatile uint32_t acmp1_status;
+    volatile uint32_t iadc0_if;
+    volatile uint32_t iadc0_status;
+    volatile uint32_t iadc0_cmpthr;
+    volatile uint32_t iadc0_singlefifodata;
+    volatile uint32_t ldma_if;
+    
+    /* MSC: host address of flash page 0, for the page lock index */
+    uintptr_t flash_base;
+} mock_periph_t;
+
+extern mock_periph_t g_mock_periph;
+
+/**
+ * @brief Reset all mock peripherals to their idle, freshly provisioned state
+ * @param trng_seed Non-zero TRNG seed
+ */
+void mock_periph_reset(uint32_t trng_seed);
+
+/**
+ * @brief Read one TRNG FIFO word
+ * @return uint32_t Pseudo-random word
+ */
+uint32_t mock_trng_read(void);
+
+#endif /* MOCK_PERIPH_H */
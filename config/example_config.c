@@ -11,6 +11,36 @@
 #include "trustzone.h"
 #include "puf.h"
 #include "anti_rollback.h"
+#include "boot_profile.h"
+#include "ramfunc.h"
+#include "warm_resume.h"
+
+/* Memory map shared by the region config and the SAU blob */
+#define EXAMPLE_NS_FLASH_START  0x00040000
+#define EXAMPLE_NS_FLASH_END    0x00100000
+#define EXAMPLE_NS_RAM_START    0x20008000
+#define EXAMPLE_NS_RAM_END      0x20020000
+
+/* Secure gateway veneers; must match the NSC region in efr32mg26_secure.ld */
+#define EXAMPLE_NSC_START       0x0003F000
+#define EXAMPLE_NSC_END         0x00040000
+
+/**
+ * @brief Precomputed SAU programming for the map below
+ * 
+ * Validated at compile time and applied by trustzone_init() in one burst,
+ * so wakeups skip the per-region checks. Secure ranges need no entry;
+ * the veneer window is Non-Secure Callable so Non-Secure code can reach
+ * the secure gateways.
+ */
+static const sau_region_words_t example_sau_words[] = {
+    SAU_REGION_WORDS(0, EXAMPLE_NS_FLASH_START, EXAMPLE_NS_FLASH_END, false),
+    SAU_REGION_WORDS(1, EXAMPLE_NS_RAM_START, EXAMPLE_NS_RAM_END, false),
+    SAU_REGION_WORDS(2, EXAMPLE_NSC_START, EXAMPLE_NSC_END, true)
+};
+
+/* Every region must fit the warm-resume snapshot, or sealing always fails */
+typedef char example_sau_fits_resume[WARM_RESUME_SAU_FITS(example_sau_words) ? 1 : -1];
 
 /**
  * @brief Example TrustZone configuration for EFR32MG26
@@ -26,8 +56,8 @@ static const trustzone_config_t example_tz_config = {
     
     /* Non-Secure Flash: 0x00040000 - 0x00100000 (768KB) */
     .flash_non_secure = {
-        .start_address = 0x00040000,
-        .end_address = 0x00100000,
+        .start_address = EXAMPLE_NS_FLASH_START,
+        .end_address = EXAMPLE_NS_FLASH_END,
         .region_type = REGION_TYPE_NON_SECURE,
         .enable = true
     },
@@ -42,8 +72,8 @@ static const trustzone_config_t example_tz_config = {
     
     /* Non-Secure RAM: 0x20008000 - 0x20020000 (96KB) */
     .ram_non_secure = {
-        .start_address = 0x20008000,
-        .end_address = 0x20020000,
+        .start_address = EXAMPLE_NS_RAM_START,
+        .end_address = EXAMPLE_NS_RAM_END,
         .region_type = REGION_TYPE_NON_SECURE,
         .enable = true
     },
@@ -56,23 +86,52 @@ static const trustzone_config_t example_tz_config = {
         .enable = true
     },
     
-    .gateway_count = 0
+    .gateway_count = 0,
+    
+    .sau_words = example_sau_words,
+    .sau_word_count = sizeof(example_sau_words) / sizeof(example_sau_words[0])
 };
 
+/**
+ * @brief Attestation report sink, one radio fragment per call
+ * 
+ * A full event log encodes to well over 4 KB of JSON, more than a RAM
+ * buffer can spare, so the report is streamed instead of buffered.
+ */
+static bool example_report_sink(void *sink_ctx, const uint8_t *data, uint32_t len) {
+    uint32_t *sent = (uint32_t *)sink_ctx;
+    
+    /* In production: Queue data[0..len) to the remote attestation server */
+    (void)data;
+    *sent += len;
+    
+    return true;
+}
+
+/**
+ * @brief End a streamed report
+ * @param json_len Bytes streamed, or 0 if the server must drop the fragments
+ */
+static void example_report_end(uint32_t json_len) {
+    /* In production: Send json_len to the remote attestation server as the trailer */
+    (void)json_len;
+}
+
 /**
  * @brief Main secure boot initialization
  */
 int main(void) {
     boot_status_t boot_status;
     tamper_context_t tamper_ctx;
+    const firmware_header_t *fw_header = (const firmware_header_t *)FIRMWARE_SLOT_ADDRESS;
+    const uint8_t *fw_image = (const uint8_t *)(FIRMWARE_SLOT_ADDRESS + sizeof(firmware_header_t));
+    bool resumed;
     
-    /* Initialize TrustZone first - isolate Secure World */
-    if (!trustzone_init(&example_tz_config)) {
-        /* TrustZone initialization failed - halt */
-        while (1);
-    }
+    /* Hash, field arithmetic and tamper ISRs run from Secure RAM */
+    ramfunc_init();
     
-    /* Initialize PUF for key derivation */
+    /* Initialize PUF for key derivation; the warm-resume MAC needs the
+     * enrolled key, so both run before the snapshot is checked */
     if (!puf_init()) {
         while (1);
     }
@@ -83,6 +142,17 @@ int main(void) {
         while (1);
     }
     
+    /* EM4 wakeup: restore the sealed snapshot (SAU, boot context, OTP
+     * shadow) in one pass; anything else takes the full boot below */
+    resumed = (warm_resume_restore(&example_tz_config, fw_header, fw_image) ==
+               TOKEN_STATE_ALL_VALID);
+    
+    /* Initialize TrustZone first - isolate Secure World */
+    if (!resumed && !trustzone_init(&example_tz_config)) {
+        /* TrustZone initialization failed - halt */
+        while (1);
+    }
+    
     /* Initialize tamper detection */
     if (!tamper_detection_start(&tamper_ctx)) {
         while (1);
@@ -93,8 +163,19 @@ int main(void) {
         while (1);
     }
     
-    /* Execute secure boot sequence */
-    boot_status = execute_secure_boot();
+    /* Report a tamper response that reset the device last time */
+    tamper_record_t tamper_record;
+    if (tamper_get_last_record(&tamper_record)) {
+        add_event_log_entry(TAMPER_LOG_EVENT_TYPE, tamper_record.event_flags,
+                            "Tamper reset recorded");
+        tamper_clear_record();
+    }
+    
+    /* Execute secure boot sequence, unless resumed from EM4 */
+    boot_status = resumed ? BOOT_STATUS_SUCCESS : execute_secure_boot();
+    
+    /* Export boot phase timing to event log (no-op unless BOOT_PROFILE=1) */
+    (void)BOOT_PROFILE_EXPORT();
     
     if (boot_status == BOOT_STATUS_SUCCESS) {
         /* Boot successful - add boot measurement */
@@ -104,22 +185,31 @@ int main(void) {
         /* Add success event */
         add_event_log_entry(1, 0, "Secure boot completed successfully");
         
-        /* Generate attestation report */
-        attestation_report_t report;
+        /* Deepest Secure stack use of the boot, to check __stack_size
+         * headroom against (a full reading means it overflowed) */
+        add_event_log_entry(1, tz_stack_high_water(), "Secure stack high water");
+        
+        /* Snapshot attestation report (read in place, no copy) */
+        attestation_view_t view;
         uint8_t nonce[NONCE_SIZE] = {0};  /* In production: from remote verifier */
         
-        if (generate_attestation_report(nonce, &report)) {
-            sign_attestation_report(&report);
+        if (attestation_snapshot(nonce, &view) && sign_attestation_view(&view)) {
+            /* Stream report to the remote attestation server (example: JSON) */
+            uint32_t json_sent = 0;
+            uint32_t json_len = export_report_json_stream(view.report, example_report_sink,
+                                                          &json_sent);
             
-            /* Export report (example: JSON) */
-            char json_buffer[4096];
-            uint32_t json_len = export_report_json(&report, json_buffer, sizeof(json_buffer));
+            /* Discard the export if the report changed while encoding */
+            if (!attestation_view_valid(&view) || json_sent != json_len) {
+                json_len = 0;
+            }
             
-            /* In production: Send report to remote attestation server */
+            example_report_end(json_len);
         }
         
-        /* Transition to Non-Secure application */
-        /* transition_to_nonsecure(0x00040000, 0x20020000); */
+        /* Transition to Non-Secure application; its EM4 requests go
+         * through warm_resume_enter_em4(fw_header) */
+        /* transition_to_nonsecure(0x00040000); */
     } else {
         /* Boot failed - log and halt */
         add_event_log_entry(2, boot_status, "Secure boot failed");
@@ -3,7 +3,9 @@
  * @brief Anti-Rollback Protection using OTP Counters
  * 
  * Implements version control and OTP counter management to prevent
- * firmware downgrade attacks.
+ * firmware downgrade attacks. The OTP counter/version block is read once
+ * at init into a RAM shadow protected by a CRC and a complement mirror;
+ * reads and checks are served from the shadow.
  */
 
 #ifndef ANTI_ROLLBACK_H
@@ -16,6 +18,14 @@
 #define OTP_COUNTER_BASE_ADDRESS    0x0FE00000  /* EFR32 OTP base */
 #define OTP_VERSION_COUNTER_OFFSET  0x100       /* Version counter offset */
 #define MAX_OTP_COUNTERS            8           /* Number of OTP counters */
+#define OTP_COUNTER_WORDS           4           /* Thermometer words per counter */
+#define OTP_COUNTER_MAX_VALUE       (OTP_COUNTER_WORDS * 32)
+
+/* Counter holding the security epoch (one bit per security release) */
+#define OTP_EPOCH_COUNTER           0
+
+/* RAM shadow size: version word followed by the decoded counters */
+#define ANTI_ROLLBACK_SHADOW_WORDS  (1 + MAX_OTP_COUNTERS)
 
 /* Version Structure */
 typedef struct {
@@ -39,9 +49,9 @@ typedef enum {
 bool anti_rollback_init(void);
 
 /**
- * @brief Read current version from OTP
+ * @brief Read current version from OTP shadow
  * @param version Pointer to version structure
- * @return true if read successful
+ * @return true if read successful and shadow intact
  */
 bool read_otp_version(version_t *version);
 
@@ -59,6 +69,25 @@ bool write_otp_version(const version_t *version);
  */
 rollback_status_t check_version_rollback(const version_t *new_version);
 
+/**
+ * @brief Compare firmware version against the shadow's complement mirror
+ * @param new_version Version to check
+ * @return rollback_status_t Comparison result
+ * 
+ * Intended for redundant glitch re-checks after check_version_rollback().
+ */
+rollback_status_t check_version_rollback_mirror(const version_t *new_version);
+
+/**
+ * @brief Advance OTP counter to at least a target value
+ * @param counter_index Counter index (0-7)
+ * @param target Target value (at most OTP_COUNTER_MAX_VALUE)
+ * @return true if counter now reads at least target
+ * 
+ * Programs only the missing bits, one write per OTP word.
+ */
+bool advance_otp_counter(uint32_t counter_index, uint32_t target);
+
 /**
  * @brief Increment OTP counter (monotonic)
  * @param counter_index Counter index (0-7)
@@ -74,6 +103,31 @@ bool increment_otp_counter(uint32_t counter_index);
  */
 bool read_otp_counter(uint32_t counter_index, uint32_t *value);
 
+/**
+ * @brief Get remaining increments before a counter is exhausted
+ * @param counter_index Counter index (0-7)
+ * @return uint32_t Unprogrammed bits left, or 0 on error
+ */
+uint32_t otp_counter_remaining(uint32_t counter_index);
+
+/**
+ * @brief Check a firmware security epoch against the OTP epoch
+ * @param epoch Security epoch from the firmware header
+ * @return rollback_status_t Comparison result; ROLLBACK_CHECK_FAIL below
+ *         the OTP epoch or above OTP_COUNTER_MAX_VALUE
+ */
+rollback_status_t check_security_epoch(uint32_t epoch);
+
+/**
+ * @brief Commit a security epoch to OTP
+ * @param epoch Epoch of the running, verified firmware
+ * @return true if OTP epoch is now at least epoch
+ * 
+ * execute_secure_boot() calls this once the image is fully verified.
+ * Patch releases that keep the same epoch spend no OTP bits.
+ */
+bool commit_security_epoch(uint32_t epoch);
+
 /**
  * @brief Verify firmware version meets anti-rollback requirements
  * @param firmware_version Version from firmware header
@@ -81,4 +135,23 @@ bool read_otp_counter(uint32_t counter_index, uint32_t *value);
  */
 rollback_status_t verify_firmware_version(uint32_t firmware_version);
 
+/**
+ * @brief Copy the OTP shadow out for a warm-resume snapshot
+ * @param words Receives ANTI_ROLLBACK_SHADOW_WORDS words
+ * @param count Capacity of words
+ * @return true if the shadow was valid and copied
+ */
+bool anti_rollback_export_shadow(uint32_t *words, uint32_t count);
+
+/**
+ * @brief Initialize from an authenticated shadow instead of reading OTP
+ * @param words Shadow words from anti_rollback_export_shadow()
+ * @param count Number of words (ANTI_ROLLBACK_SHADOW_WORDS)
+ * @return true if the shadow was installed
+ * 
+ * Only for the EM4 warm-resume path, after the snapshot MAC has been
+ * verified; OTP cannot change while the device sleeps.
+ */
+bool anti_rollback_resume(const uint32_t *words, uint32_t count);
+
 #endif /* ANTI_ROLLBACK_H */
@@ -4,6 +4,11 @@
  * 
  * Provides signed boot health reports and telemetry in JSON/CBOR format
  * for remote attestation and forensics.
+ * 
+ * Measurements and events are also folded into running hash chains
+ * (measured-boot PCR style), so the signature covers a fixed-size claims
+ * tuple rather than the whole report: answering a challenge costs one
+ * small hash and one signature, whatever the size of the logs.
  */
 
 #ifndef ATTESTATION_H
@@ -17,10 +22,48 @@
 
 /* Maximum sizes */
 #define MAX_MEASUREMENT_COUNT       16
-#define MAX_EVENT_LOG_ENTRIES       32
+#define MAX_EVENT_LOG_ENTRIES       64   /* Event ring capacity (power of two) */
 #define ATTESTATION_SIGNATURE_SIZE  64
 #define NONCE_SIZE                  16
 
+/* Compact event log entries */
+#define EVENT_PAYLOAD_SIZE          6    /* Optional inline payload bytes */
+#define EVENT_STRING_TABLE_SIZE     32   /* Interned description strings */
+#define EVENT_STRING_MAX_LEN        64   /* Longest exported description */
+#define EVENT_STRING_NONE           0xFF /* Entry has no description */
+
+/* Streaming export: bytes handed to the sink per call (radio fragment) */
+#ifndef ATTESTATION_SINK_CHUNK_SIZE
+#define ATTESTATION_SINK_CHUNK_SIZE 64
+#endif
+
+/* CBOR report map keys */
+#define CBOR_KEY_VERSION            1
+#define CBOR_KEY_BOOT_COUNT         2
+#define CBOR_KEY_FIRMWARE_VERSION   3
+#define CBOR_KEY_NONCE              4
+#define CBOR_KEY_SECURITY_STATUS    5
+#define CBOR_KEY_TAMPER_EVENTS      6
+#define CBOR_KEY_UPTIME             7
+#define CBOR_KEY_MEASUREMENTS       8   /* [[component_id, bstr, type], ...] */
+#define CBOR_KEY_EVENTS             9   /* [[seq, type, data, timestamp, tstr, bstr], ...] */
+#define CBOR_KEY_SIGNATURE          10
+#define CBOR_KEY_EVENTS_DROPPED     11
+#define CBOR_KEY_MEASUREMENT_DIGEST 12
+#define CBOR_KEY_EVENT_DIGEST       13
+#define CBOR_KEY_EVENT_DIGEST_SEQ   14
+#define CBOR_KEY_MEASUREMENT_BASE   15  /* Delta: index of first measurement sent */
+#define CBOR_KEY_EVENT_BASE         16  /* Delta: events sent follow this sequence */
+#define CBOR_REPORT_MAP_ENTRIES     14
+#define CBOR_DELTA_MAP_ENTRIES      16
+
+/* Running digests (SHA-256) */
+#define ATTESTATION_DIGEST_SIZE     32
+
+/* Event chain record tags */
+#define EVENT_CHAIN_TAG_ENTRY       0x01 /* seq, type, data, timestamp, description, payload */
+#define EVENT_CHAIN_TAG_LOST        0x02 /* first_seq, count: overwritten before folding */
+
 /* Boot Measurement Structure */
 typedef struct {
     uint32_t component_id;       /* Component identifier */
@@ -28,12 +71,15 @@ typedef struct {
     uint32_t measurement_type;   /* Type of measurement */
 } boot_measurement_t;
 
-/* Event Log Entry */
+/* Event Log Entry (one ring slot) */
 typedef struct {
+    uint32_t sequence;           /* Sequence number, written last (0 = empty) */
     uint32_t event_type;         /* Type of event */
-    uint64_t timestamp;          /* Event timestamp */
     uint32_t event_data;         /* Event-specific data */
-    char description[64];        /* Event description */
+    uint32_t timestamp;          /* Event timestamp (RTC ticks) */
+    uint8_t string_id;           /* Interned description, or EVENT_STRING_NONE */
+    uint8_t payload_len;         /* Valid bytes in payload */
+    uint8_t payload[EVENT_PAYLOAD_SIZE];  /* Optional short payload */
 } event_log_entry_t;
 
 /* Attestation Report Structure */
@@ -47,8 +93,11 @@ typedef struct {
     uint32_t measurement_count;
     boot_measurement_t measurements[MAX_MEASUREMENT_COUNT];
     
-    /* Event log */
-    uint32_t event_count;
+    /* Event log (ring; holds sequences event_sequence - event_count + 1
+     * through event_sequence, slot = (sequence - 1) % MAX_EVENT_LOG_ENTRIES) */
+    uint32_t event_count;        /* Entries held in ring */
+    uint32_t event_sequence;     /* Sequence number of newest event */
+    uint32_t events_dropped;     /* Oldest entries overwritten */
     event_log_entry_t events[MAX_EVENT_LOG_ENTRIES];
     
     /* Health status */
@@ -56,10 +105,53 @@ typedef struct {
     uint32_t security_status;    /* Security flags */
     uint64_t uptime;             /* System uptime */
     
+    /* Running digests, covered by the signature */
+    uint8_t measurement_digest[ATTESTATION_DIGEST_SIZE];  /* Chain over measurements */
+    uint8_t event_digest[ATTESTATION_DIGEST_SIZE];        /* Chain over events */
+    uint32_t event_digest_sequence;  /* Newest event folded into event_digest */
+    
     /* Signature */
     uint8_t signature[ATTESTATION_SIGNATURE_SIZE];
 } attestation_report_t;
 
+/* Signed Claims Tuple (little-endian, packed)
+ * 
+ * The signature is over SHA-256 of this structure. Chains start at zero
+ * and extend as D = SHA-256(D || record):
+ *   measurement record: component_id, type (uint32 LE), measurement[32]
+ *   event record:       EVENT_CHAIN_TAG_ENTRY, sequence, type, data,
+ *                       timestamp (uint32 LE), description length (uint8),
+ *                       description, payload_len (uint8), payload
+ *   lost record:        EVENT_CHAIN_TAG_LOST, first sequence, count (uint32 LE) */
+typedef struct __attribute__((packed)) {
+    uint32_t version;
+    uint8_t nonce[NONCE_SIZE];
+    uint32_t boot_count;
+    uint32_t firmware_version;
+    uint32_t security_status;
+    uint32_t tamper_events;
+    uint64_t uptime;
+    uint32_t measurement_count;
+    uint8_t measurement_digest[ATTESTATION_DIGEST_SIZE];
+    uint32_t event_digest_sequence;
+    uint8_t event_digest[ATTESTATION_DIGEST_SIZE];
+} attestation_claims_t;
+
+/* Verifier Acknowledgement (state the verifier already holds) */
+typedef struct {
+    uint32_t event_sequence;     /* Newest event replayed, 0 if none */
+    uint8_t measurement_digest[ATTESTATION_DIGEST_SIZE];  /* Chain value replayed */
+} attestation_ack_t;
+
+/* Output sink for streaming export; return false to abort */
+typedef bool (*attestation_sink_t)(void *sink_ctx, const uint8_t *data, uint32_t len);
+
+/* Read-Only Report View (zero-copy access to the live report) */
+typedef struct {
+    const attestation_report_t *report;  /* Live report, read in place */
+    uint32_t generation;                 /* Report generation at snapshot */
+} attestation_view_t;
+
 /**
  * @brief Initialize attestation system
  * @return true if initialization successful
@@ -72,6 +164,8 @@ bool attestation_init(void);
  * @param measurement Measurement hash
  * @param type Measurement type
  * @return true if measurement added successfully
+ * 
+ * Also extends measurement_digest. Thread context only.
  */
 bool add_boot_measurement(uint32_t component_id, const uint8_t *measurement, uint32_t type);
 
@@ -79,42 +173,191 @@ bool add_boot_measurement(uint32_t component_id, const uint8_t *measurement, uin
  * @brief Add event to log
  * @param event_type Type of event
  * @param event_data Event data
- * @param description Event description
+ * @param description Event description (static storage), or NULL
  * @return true if event added successfully
+ * 
+ * Interns the description, then logs as add_event_log_entry_id(). When
+ * the ring is full the oldest entry is overwritten and counted in
+ * events_dropped. Safe to call from interrupt handlers only if the
+ * description was already interned with attestation_intern_string().
  */
 bool add_event_log_entry(uint32_t event_type, uint32_t event_data, const char *description);
 
+/**
+ * @brief Add event to log by interned string ID
+ * @param event_type Type of event
+ * @param event_data Event data
+ * @param string_id ID from attestation_intern_string(), or EVENT_STRING_NONE
+ * @param payload Optional payload bytes, or NULL
+ * @param payload_len Payload length (at most EVENT_PAYLOAD_SIZE)
+ * @return true if event added successfully
+ * 
+ * Lock-free; callable from thread context and interrupt handlers. The
+ * entry is folded into event_digest later, in thread context, when the
+ * next report is generated.
+ */
+bool add_event_log_entry_id(uint32_t event_type, uint32_t event_data, uint8_t string_id,
+                            const uint8_t *payload, uint32_t payload_len);
+
+/**
+ * @brief Intern an event description string
+ * @param text Description with static storage duration (stored by reference)
+ * @return String ID, or EVENT_STRING_NONE if table full or text NULL
+ * 
+ * Thread context only. Re-interning an equal string returns the same ID.
+ */
+uint8_t attestation_intern_string(const char *text);
+
+/**
+ * @brief Look up an interned event description
+ * @param string_id String ID
+ * @return Description, or NULL if ID unknown
+ */
+const char *attestation_event_string(uint8_t string_id);
+
 /**
  * @brief Generate attestation report
  * @param nonce Challenge nonce for freshness
- * @param report Pointer to report structure to fill
+ * @param report Pointer to report structure to fill, or NULL to skip the copy
  * @return true if report generated successfully
  */
 bool generate_attestation_report(const uint8_t *nonce, attestation_report_t *report);
 
+/**
+ * @brief Snapshot the live report for in-place reading
+ * @param nonce Challenge nonce for freshness
+ * @param view Pointer to view to fill
+ * @return true if snapshot taken successfully
+ * 
+ * Every later update to the report (measurement, event) advances the
+ * generation; readers call attestation_view_valid() after reading to
+ * detect that the report changed underneath them.
+ */
+bool attestation_snapshot(const uint8_t *nonce, attestation_view_t *view);
+
+/**
+ * @brief Check that a view still matches the live report
+ * @param view Pointer to view
+ * @return true if report unchanged since snapshot
+ */
+bool attestation_view_valid(const attestation_view_t *view);
+
+/**
+ * @brief Fold events logged since the last report into event_digest
+ * @return true if every published event was folded
+ * 
+ * Thread context only. Called by generate_attestation_report() and
+ * attestation_snapshot(); calling it between challenges bounds the work
+ * done at challenge time and keeps events from being overwritten in the
+ * ring before they are folded (those are recorded as lost).
+ */
+bool attestation_fold_events(void);
+
+/**
+ * @brief Compute the digest the report signature covers
+ * @param report Pointer to report structure
+ * @param digest Output (ATTESTATION_DIGEST_SIZE bytes)
+ * @return true if computed
+ * 
+ * SHA-256 of the report's attestation_claims_t; verifiers recompute it
+ * from the exported fields.
+ */
+bool attestation_claims_digest(const attestation_report_t *report, uint8_t *digest);
+
 /**
  * @brief Sign attestation report
  * @param report Pointer to report structure
  * @return true if signing successful
+ * 
+ * Signs attestation_claims_digest(), not the report body.
  */
 bool sign_attestation_report(attestation_report_t *report);
 
+/**
+ * @brief Sign the live report in place through a view
+ * @param view Pointer to view from attestation_snapshot()
+ * @return true if signing successful and the view was still valid
+ */
+bool sign_attestation_view(const attestation_view_t *view);
+
 /**
  * @brief Export report to JSON format
  * @param report Pointer to report structure
- * @param json_buffer Output buffer for JSON
+ * @param json_buffer Output buffer for JSON (always NUL-terminated)
  * @param buffer_size Size of output buffer
- * @return Number of bytes written, or 0 on error
+ * @return Number of bytes written, or 0 on error or truncation
+ * 
+ * A full event log encodes to about 11 KB; export_report_json_stream()
+ * sends it without a buffer that size.
  */
 uint32_t export_report_json(const attestation_report_t *report, char *json_buffer, uint32_t buffer_size);
 
+/**
+ * @brief Stream report as JSON into a sink
+ * @param report Pointer to report structure
+ * @param sink Sink receiving fragments of up to ATTESTATION_SINK_CHUNK_SIZE bytes
+ * @param sink_ctx Opaque context passed to sink
+ * @return Number of bytes emitted, or 0 on error or if sink aborted
+ */
+uint32_t export_report_json_stream(const attestation_report_t *report,
+                                   attestation_sink_t sink, void *sink_ctx);
+
 /**
  * @brief Export report to CBOR format
  * @param report Pointer to report structure
  * @param cbor_buffer Output buffer for CBOR
  * @param buffer_size Size of output buffer
- * @return Number of bytes written, or 0 on error
+ * @return Number of bytes written, or 0 on error or if buffer too small
  */
 uint32_t export_report_cbor(const attestation_report_t *report, uint8_t *cbor_buffer, uint32_t buffer_size);
 
+/**
+ * @brief Compute exact CBOR encoded size of a report
+ * @param report Pointer to report structure
+ * @return Encoded size in bytes, or 0 on error
+ */
+uint32_t cbor_encoded_size(const attestation_report_t *report);
+
+/**
+ * @brief Stream report as CBOR into a sink
+ * @param report Pointer to report structure
+ * @param sink Sink receiving fragments of up to ATTESTATION_SINK_CHUNK_SIZE bytes
+ * @param sink_ctx Opaque context passed to sink
+ * @return Number of bytes emitted, or 0 on error or if sink aborted
+ */
+uint32_t export_report_cbor_stream(const attestation_report_t *report,
+                                   attestation_sink_t sink, void *sink_ctx);
+
+/**
+ * @brief Export only what a verifier has not seen, as CBOR
+ * @param report Pointer to report structure
+ * @param ack State acknowledged by the verifier
+ * @param cbor_buffer Output buffer for CBOR
+ * @param buffer_size Size of output buffer
+ * @return Number of bytes written, or 0 on error or if buffer too small
+ * 
+ * Same map as export_report_cbor(), with the same full-state signature,
+ * but measurements start at CBOR_KEY_MEASUREMENT_BASE (the longest prefix
+ * whose chain matches ack->measurement_digest) and events are those after
+ * CBOR_KEY_EVENT_BASE up to event_digest_sequence. The verifier extends
+ * its own chains with them and checks the result against the signed
+ * digests. If ack->event_sequence is ahead of the device (reset), the
+ * event base is 0; if the first event sent does not follow the base,
+ * entries were lost and the verifier re-bases on event_digest.
+ */
+uint32_t export_report_cbor_delta(const attestation_report_t *report, const attestation_ack_t *ack,
+                                  uint8_t *cbor_buffer, uint32_t buffer_size);
+
+/**
+ * @brief Stream a delta report as CBOR into a sink
+ * @param report Pointer to report structure
+ * @param ack State acknowledged by the verifier
+ * @param sink Sink receiving fragments of up to ATTESTATION_SINK_CHUNK_SIZE bytes
+ * @param sink_ctx Opaque context passed to sink
+ * @return Number of bytes emitted, or 0 on error or if sink aborted
+ */
+uint32_t export_report_cbor_delta_stream(const attestation_report_t *report,
+                                         const attestation_ack_t *ack,
+                                         attestation_sink_t sink, void *sink_ctx);
+
 #endif /* ATTESTATION_H */
@@ -0,0 +1,104 @@
+/**
+ * @file boot_profile.h
+ * @brief Boot-Time Cycle Count Instrumentation
+ * 
+ * Records per-phase DWT->CYCCNT start/stop counts for the secure boot
+ * sequence into a fixed RAM table, with jitter time accounted separately
+ * from real work. Build with BOOT_PROFILE=1 to enable; otherwise all
+ * instrumentation macros compile to nothing.
+ */
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Attestation event type used when exporting the profile */
+#define BOOT_PROFILE_EVENT_TYPE     0x00000010
+
+/* Profiled Boot Phases */
+typedef enum {
+    BOOT_PHASE_TOTAL = 0,        /* Whole execute_secure_boot() run */
+    BOOT_PHASE_INIT,             /* secure_boot_init() */
+    BOOT_PHASE_TOKENS,           /* verify_layered_tokens() */
+    BOOT_PHASE_SIGNATURE,        /* verify_firmware_signature() */
+    BOOT_PHASE_ROLLBACK,         /* check_anti_rollback() */
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+/* Per-Phase Profile Record */
+typedef struct {
+    uint32_t start_cycles;       /* CYCCNT at phase start */
+    uint32_t end_cycles;         /* CYCCNT at phase end */
+    uint32_t jitter_cycles;      /* Cycles spent in jitter during phase */
+    uint32_t parent;             /* Enclosing phase while active */
+} boot_phase_record_t;
+
+/**
+ * @brief Read the DWT cycle counter
+ * @return uint32_t Current CYCCNT value
+ */
+uint32_t boot_profile_cycles(void);
+
+#ifdef BOOT_PROFILE_ENABLED
+
+/**
+ * @brief Enable DWT cycle counter and clear the profile table
+ */
+void boot_profile_init(void);
+
+/**
+ * @brief Mark start of a boot phase
+ * @param phase Phase identifier
+ */
+void boot_profile_phase_start(boot_phase_t phase);
+
+/**
+ * @brief Mark end of a boot phase
+ * @param phase Phase identifier
+ */
+void boot_profile_phase_end(boot_phase_t phase);
+
+/**
+ * @brief Mark start of a jitter delay
+ */
+void boot_profile_jitter_begin(void);
+
+/**
+ * @brief Mark end of a jitter delay and charge it to the active phase
+ */
+void boot_profile_jitter_end(void);
+
+/**
+ * @brief Get profile record for a phase
+ * @param phase Phase identifier
+ * @return Pointer to record, or NULL if phase invalid
+ */
+const boot_phase_record_t *boot_profile_get(boot_phase_t phase);
+
+/**
+ * @brief Export profile table to attestation event log
+ * @return true if all phases were logged
+ */
+bool boot_profile_export(void);
+
+#define BOOT_PROFILE_INIT()             boot_profile_init()
+#define BOOT_PROFILE_START(phase)       boot_profile_phase_start(phase)
+#define BOOT_PROFILE_END(phase)         boot_profile_phase_end(phase)
+#define BOOT_PROFILE_JITTER_BEGIN()     boot_profile_jitter_begin()
+#define BOOT_PROFILE_JITTER_END()       boot_profile_jitter_end()
+#define BOOT_PROFILE_EXPORT()           boot_profile_export()
+
+#else
+
+#define BOOT_PROFILE_INIT()             ((void)0)
+#define BOOT_PROFILE_START(phase)       ((void)0)
+#define BOOT_PROFILE_END(phase)         ((void)0)
+#define BOOT_PROFILE_JITTER_BEGIN()     ((void)0)
+#define BOOT_PROFILE_JITTER_END()       ((void)0)
+#define BOOT_PROFILE_EXPORT()           (true)
+
+#endif /* BOOT_PROFILE_ENABLED */
+
+#endif /* BOOT_PROFILE_H */
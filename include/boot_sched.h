@@ -0,0 +1,74 @@
+/**
+ * @file boot_sched.h
+ * @brief Cooperative Boot Job Scheduler
+ * 
+ * Long-latency boot operations (SE mailbox commands, LDMA transfers,
+ * sensor warmup) are submitted as jobs whose step function starts or
+ * advances the hardware and returns immediately. CPU-only boot work polls
+ * the scheduler between its own steps, and the final boot decision joins
+ * every job first. Single core, no preemption: steps never block.
+ */
+
+#ifndef BOOT_SCHED_H
+#define BOOT_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Jobs per boot (slots are released by boot_sched_reset()) */
+#define BOOT_SCHED_MAX_JOBS     4
+
+/* Job Status */
+typedef enum {
+    BOOT_JOB_PENDING = 0,        /* Waiting on hardware, step again later */
+    BOOT_JOB_DONE,               /* Completed successfully */
+    BOOT_JOB_FAILED              /* Completed with an error */
+} boot_job_status_t;
+
+/* Advance a job without blocking */
+typedef boot_job_status_t (*boot_job_step_t)(void *ctx);
+
+/* Boot Job (storage owned by the submitter until joined) */
+typedef struct {
+    boot_job_step_t step;        /* Step function */
+    void *ctx;                   /* Step function context */
+    volatile boot_job_status_t status;
+} boot_job_t;
+
+/**
+ * @brief Drop all jobs
+ */
+void boot_sched_reset(void);
+
+/**
+ * @brief Submit a job; its first step runs immediately
+ * @param job Job storage
+ * @param step Step function
+ * @param ctx Step function context
+ * @return true if queued (or already completed by the first step)
+ */
+bool boot_sched_submit(boot_job_t *job, boot_job_step_t step, void *ctx);
+
+/**
+ * @brief Step every pending job once
+ * @return uint32_t Jobs still pending
+ * 
+ * Safe to call from anywhere; nested calls from inside a step return
+ * without stepping.
+ */
+uint32_t boot_sched_poll(void);
+
+/**
+ * @brief Run the scheduler until a job completes
+ * @param job Job to wait for
+ * @return boot_job_status_t Final status (DONE or FAILED)
+ */
+boot_job_status_t boot_sched_join(boot_job_t *job);
+
+/**
+ * @brief Run the scheduler until every job completes
+ * @return true if all jobs completed successfully
+ */
+bool boot_sched_join_all(void);
+
+#endif /* BOOT_SCHED_H */
@@ -0,0 +1,94 @@
+/**
+ * @file ecdsa_p256.h
+ * @brief ECDSA P-256 Firmware Signature Verification
+ * 
+ * Verifies signatures against the root firmware signing key with one of
+ * two backends behind a common API: the Secure Vault accelerator, or a
+ * software fallback for parts and modes without SE access (e.g.
+ * recovery). The software backend uses fixed-base comb tables for the
+ * generator and the root key, generated at build time by
+ * tools/gen_p256_comb.py and linked into Secure flash, so verification
+ * needs no generic scalar multiplication.
+ */
+
+#ifndef ECDSA_P256_H
+#define ECDSA_P256_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Sizes (big-endian encodings) */
+#define ECDSA_P256_HASH_SIZE        32
+#define ECDSA_P256_SIGNATURE_SIZE   64   /* r || s */
+#define ECDSA_P256_PUBKEY_SIZE      64   /* X || Y */
+
+/* Verification results - non-binary values for glitch resistance */
+#define ECDSA_VERIFY_INVALID        0x00000000
+#define ECDSA_VERIFY_VALID          0x3CA5965A
+
+/* Comb teeth per table; must match the generator's --teeth */
+#ifndef ECDSA_COMB_TEETH
+#define ECDSA_COMB_TEETH            5
+#endif
+#define ECDSA_COMB_POINTS           ((1U << ECDSA_COMB_TEETH) - 1)
+
+/* Verification Backends */
+typedef enum {
+    ECDSA_BACKEND_AUTO = 0,      /* SE when it answers, otherwise software */
+    ECDSA_BACKEND_SE,            /* Secure Vault accelerator */
+    ECDSA_BACKEND_SW_COMB,       /* Software with flash comb tables */
+    ECDSA_BACKEND_COUNT
+} ecdsa_backend_t;
+
+/* Default backend used by verify_firmware_signature() */
+#ifndef ECDSA_DEFAULT_BACKEND
+#define ECDSA_DEFAULT_BACKEND       ECDSA_BACKEND_AUTO
+#endif
+
+/* Per-Backend Statistics (cycles from DWT->CYCCNT) */
+typedef struct {
+    uint32_t verifications;      /* Completed verifications */
+    uint32_t failures;           /* Signatures rejected */
+    uint32_t last_cycles;        /* Cycles of the latest verification */
+    uint32_t max_cycles;         /* Slowest verification */
+} ecdsa_stats_t;
+
+/* Comb table entry: affine point, Montgomery-domain little-endian limbs */
+typedef struct {
+    uint32_t x[8];
+    uint32_t y[8];
+} ecdsa_comb_point_t;
+
+/* Build-time tables (generated from config/root_pubkey.hex) */
+extern const uint8_t g_ecdsa_root_pubkey[ECDSA_P256_PUBKEY_SIZE];
+extern const ecdsa_comb_point_t g_ecdsa_comb_g[ECDSA_COMB_POINTS];
+extern const ecdsa_comb_point_t g_ecdsa_comb_root[ECDSA_COMB_POINTS];
+
+/**
+ * @brief Verify a signature against the root firmware signing key
+ * @param backend Backend to use (AUTO falls back to software without SE)
+ * @param hash Message digest (ECDSA_P256_HASH_SIZE bytes)
+ * @param signature Signature r || s (ECDSA_P256_SIGNATURE_SIZE bytes)
+ * @return uint32_t ECDSA_VERIFY_VALID or ECDSA_VERIFY_INVALID
+ */
+uint32_t ecdsa_p256_verify(ecdsa_backend_t backend, const uint8_t *hash,
+                           const uint8_t *signature);
+
+/**
+ * @brief Check whether the Secure Vault can serve verifications
+ * @return true if the SE mailbox is up
+ */
+bool ecdsa_p256_se_available(void);
+
+/**
+ * @brief Get statistics for one backend
+ * @param backend ECDSA_BACKEND_SE or ECDSA_BACKEND_SW_COMB
+ * @param stats Pointer to receive statistics
+ * @return true if backend valid
+ * 
+ * Cycle counts are only meaningful while the DWT cycle counter runs
+ * (BOOT_PROFILE=1, or enabled by a debugger).
+ */
+bool ecdsa_p256_get_stats(ecdsa_backend_t backend, ecdsa_stats_t *stats);
+
+#endif /* ECDSA_P256_H */
@@ -0,0 +1,77 @@
+/**
+ * @file entropy_pool.h
+ * @brief TRNG Entropy Pool with Batched Refill
+ * 
+ * Buffers TRNG output in a lock-free ring so latency-sensitive callers
+ * (random jitter) never wait on the TRNG FIFO. The ring is refilled in
+ * bursts from the TRNG interrupt and every burst passes a health test
+ * before it is made available.
+ */
+
+#ifndef ENTROPY_POOL_H
+#define ENTROPY_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Pool sizing (ENTROPY_POOL_WORDS must be a power of two) */
+#define ENTROPY_POOL_WORDS          64
+#define ENTROPY_POOL_LOW_WATER      16   /* Request refill below this level */
+#define TRNG_FIFO_DEPTH             16   /* Words per TRNG FIFO burst */
+
+/* Health test hook: return true if the batch is acceptable */
+typedef bool (*entropy_health_test_t)(const uint32_t *words, uint32_t count);
+
+/* Entropy Pool Statistics */
+typedef struct {
+    uint32_t refills;            /* Accepted TRNG bursts */
+    uint32_t health_failures;    /* Bursts rejected by health test */
+    uint32_t underruns;          /* Reads served while pool was empty */
+} entropy_pool_stats_t;
+
+/**
+ * @brief Start TRNG and fill the pool
+ * @return true if pool filled and initial health test passed
+ */
+bool entropy_pool_init(void);
+
+/**
+ * @brief Install a health test run on each refill burst
+ * @param test Health test function, or NULL for the built-in test
+ */
+void entropy_pool_set_health_test(entropy_health_test_t test);
+
+/**
+ * @brief Read one word from the pool without blocking
+ * @param word Pointer to receive random word
+ * @return true if a TRNG word was available
+ */
+bool entropy_pool_read(uint32_t *word);
+
+/**
+ * @brief Get one word for jitter; never blocks
+ * @return uint32_t Random word
+ * 
+ * On underrun a whitened fallback word is returned and a refill is
+ * requested. Not suitable for key material; use entropy_pool_read().
+ */
+uint32_t entropy_pool_get_word(void);
+
+/**
+ * @brief Get number of words currently buffered
+ * @return uint32_t Buffered word count
+ */
+uint32_t entropy_pool_level(void);
+
+/**
+ * @brief Get pool statistics
+ * @param stats Pointer to receive statistics
+ */
+void entropy_pool_get_stats(entropy_pool_stats_t *stats);
+
+/**
+ * @brief TRNG interrupt handler (FIFO full)
+ */
+void trng_irq_handler(void);
+
+#endif /* ENTROPY_POOL_H */
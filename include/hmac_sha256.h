@@ -0,0 +1,42 @@
+/**
+ * @file hmac_sha256.h
+ * @brief HMAC-SHA256 (RFC 2104) over Scattered Messages
+ * 
+ * Keyed MAC used for the Secure-storage records (verified-image cache,
+ * warm-resume snapshot). The message is given as fragments so callers
+ * can MAC a header and their own state without assembling a copy.
+ */
+
+#ifndef HMAC_SHA256_H
+#define HMAC_SHA256_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sha256.h"
+
+/* Full tag size; callers may keep a prefix */
+#define HMAC_SHA256_SIZE    SHA256_DIGEST_SIZE
+
+/* One message fragment; fragments are MACed back to back */
+typedef struct {
+    const void *data;
+    uint32_t length;
+} hmac_sha256_part_t;
+
+/**
+ * @brief Compute HMAC-SHA256 over a list of fragments
+ * @param key MAC key
+ * @param key_len Key length (hashed first if longer than a block)
+ * @param parts Message fragments
+ * @param count Number of fragments
+ * @param mac Output buffer (mac_len bytes)
+ * @param mac_len Tag length, 1 to HMAC_SHA256_SIZE (truncated tag)
+ * @return true if computed
+ * 
+ * Pads and the inner digest are zeroized; the key stays the caller's.
+ */
+bool hmac_sha256(const uint8_t *key, uint32_t key_len,
+                 const hmac_sha256_part_t *parts, uint32_t count,
+                 uint8_t *mac, uint32_t mac_len);
+
+#endif /* HMAC_SHA256_H */
@@ -0,0 +1,114 @@
+/**
+ * @file image_hash.h
+ * @brief Streaming Firmware Image Hashing for EFR32MG26
+ * 
+ * Hashes firmware images in fixed-size chunks. The pipelined backend
+ * double-buffers LDMA flash reads against Secure Vault SHA-256 so the
+ * read of chunk N+1 overlaps hashing of chunk N. A plain CPU backend is
+ * provided as fallback and as a benchmark reference.
+ */
+
+#ifndef IMAGE_HASH_H
+#define IMAGE_HASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sha256.h"
+#include "boot_sched.h"
+
+/* Chunk size for streaming (two chunk buffers live in Secure RAM) */
+#ifndef IMAGE_HASH_CHUNK_SIZE
+#define IMAGE_HASH_CHUNK_SIZE   2048
+#endif
+
+/* Hash Backend Selection */
+typedef enum {
+    IMAGE_HASH_BACKEND_CPU = 0x01,         /* Software SHA-256 from flash */
+    IMAGE_HASH_BACKEND_SE_PIPELINED = 0x02 /* LDMA -> SE mailbox, double-buffered */
+} image_hash_backend_t;
+
+/* Default backend used by verify_firmware_signature() */
+#ifndef IMAGE_HASH_DEFAULT_BACKEND
+#define IMAGE_HASH_DEFAULT_BACKEND  IMAGE_HASH_BACKEND_SE_PIPELINED
+#endif
+
+/* Resumable Hash Job (one pipelined job at a time: chunk buffers are shared) */
+typedef struct {
+    const uint8_t *image;        /* Image being hashed */
+    uint32_t image_size;         /* Total bytes */
+    uint32_t offset;             /* Bytes submitted so far */
+    uint32_t len;                /* Bytes in the current chunk */
+    uint32_t current;            /* Chunk buffer holding the current chunk */
+    bool chunk_ready;            /* Current chunk has landed in RAM */
+    image_hash_backend_t backend;
+    sha256_context_t cpu;        /* CPU backend state */
+    uint8_t *digest;             /* Output */
+} image_hash_job_t;
+
+/**
+ * @brief Start a resumable image hash
+ * @param job Job state
+ * @param image Pointer to image in flash
+ * @param image_size Size of image in bytes
+ * @param backend Hash backend to use
+ * @param digest Output buffer, written when the job completes
+ * @return true if started
+ */
+bool image_hash_begin(image_hash_job_t *job, const uint8_t *image, uint32_t image_size,
+                      image_hash_backend_t backend, uint8_t *digest);
+
+/**
+ * @brief Advance a resumable image hash without blocking
+ * @param job Job state
+ * @return boot_job_status_t PENDING until the digest is written
+ * 
+ * The pipelined backend returns PENDING while LDMA or the SE is busy;
+ * the CPU backend hashes one chunk per call.
+ */
+boot_job_status_t image_hash_step(image_hash_job_t *job);
+
+/* Streaming Hash (caller produces the data, e.g. a decompressor) */
+typedef struct {
+    image_hash_backend_t backend;
+    sha256_context_t cpu;        /* CPU backend state */
+} image_hash_stream_t;
+
+/**
+ * @brief Open a streaming image hash
+ * @param stream Stream state
+ * @param backend Hash backend to use
+ * @return true if opened
+ */
+bool image_hash_stream_start(image_hash_stream_t *stream, image_hash_backend_t backend);
+
+/**
+ * @brief Feed data to a streaming image hash
+ * @param stream Stream state
+ * @param data Data to hash
+ * @param len Length in bytes
+ * 
+ * With the SE backend the data is handed over without waiting for it to
+ * be hashed: it must stay unmodified until the next update or finish,
+ * which first wait for the SE to release it.
+ */
+void image_hash_stream_update(image_hash_stream_t *stream, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Close a streaming image hash
+ * @param stream Stream state
+ * @param digest Output buffer (SHA256_DIGEST_SIZE bytes)
+ */
+void image_hash_stream_finish(image_hash_stream_t *stream, uint8_t *digest);
+
+/**
+ * @brief Compute SHA-256 of a firmware image
+ * @param image Pointer to image in flash
+ * @param image_size Size of image in bytes
+ * @param backend Hash backend to use
+ * @param digest Output buffer (SHA256_DIGEST_SIZE bytes)
+ * @return true if hash computed successfully
+ */
+bool image_hash_compute(const uint8_t *image, uint32_t image_size,
+                        image_hash_backend_t backend, uint8_t *digest);
+
+#endif /* IMAGE_HASH_H */
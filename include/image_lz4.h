@@ -0,0 +1,78 @@
+/**
+ * @file image_lz4.h
+ * @brief LZ4-Compressed Firmware Images with Fused Hashing
+ * 
+ * Images flagged FIRMWARE_FLAG_LZ4 store the image as a stream of LZ4
+ * blocks behind a small descriptor. Boot decompresses block by block
+ * straight into load_address (Non-Secure RAM) and hands each finished
+ * block to the hash engine while the next one is decoded, so image data
+ * is written once and read once. header->image_size and header->hash
+ * describe the decompressed image.
+ * 
+ * Slot layout: firmware_header_t | image_lz4_ext_t | blocks
+ * Block:       uint32_t record (bit 31 = stored raw, bits 30:0 = length)
+ *              followed by that many bytes of LZ4 block data
+ * 
+ * Matches may reach back into earlier blocks (up to 64KB, LZ4 offsets),
+ * as all of the output stays in place at load_address.
+ */
+
+#ifndef IMAGE_LZ4_H
+#define IMAGE_LZ4_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "secure_boot.h"
+#include "image_hash.h"
+
+/* Block geometry (decompressed block size) */
+#define IMAGE_LZ4_BLOCK_LOG2_MIN    10      /* 1KB */
+#define IMAGE_LZ4_BLOCK_LOG2_MAX    16      /* 64KB */
+
+/* Block record */
+#define IMAGE_LZ4_BLOCK_STORED      (1UL << 31)
+#define IMAGE_LZ4_BLOCK_LEN_MASK    0x7FFFFFFFUL
+
+/* Decompression target: SRAM, and Non-Secure per the SAU */
+#define IMAGE_LZ4_SRAM_START        0x20000000UL
+#define IMAGE_LZ4_SRAM_END          0x20080000UL
+
+/* Block Stream Descriptor (follows firmware_header_t) */
+typedef struct __attribute__((packed)) {
+    uint32_t block_log2;         /* log2 of decompressed block size */
+    uint32_t compressed_size;    /* Bytes of block stream that follow */
+} image_lz4_ext_t;
+
+/**
+ * @brief Decompress a block stream and hash the output in the same pass
+ * @param ext Descriptor at the start of the slot payload
+ * @param dest Output buffer (image_size bytes)
+ * @param image_size Decompressed size
+ * @param backend Hash backend to use
+ * @param digest Output (SHA256_DIGEST_SIZE bytes)
+ * @return true if the stream decoded to exactly image_size bytes
+ * 
+ * The stream is untrusted until the digest is checked: every read and
+ * write is bounds-checked, and on a decode error dest is cleared.
+ */
+bool image_lz4_decompress(const image_lz4_ext_t *ext, uint8_t *dest, uint32_t image_size,
+                          image_hash_backend_t backend, uint8_t *digest);
+
+/**
+ * @brief Decompress a flagged image to its load_address and hash it
+ * @param header Firmware header
+ * @param image Bytes following the header in the slot
+ * @param digest Output (SHA256_DIGEST_SIZE bytes)
+ * @return true if load_address is valid and the image decoded
+ */
+bool image_lz4_load(const firmware_header_t *header, const uint8_t *image, uint8_t *digest);
+
+/**
+ * @brief Get the bytes an LZ4 image occupies after the header
+ * @param header Firmware header (FIRMWARE_FLAG_LZ4)
+ * @param image Bytes following the header in the slot
+ * @return uint32_t Descriptor + compressed stream, or 0 if malformed
+ */
+uint32_t image_lz4_stored_size(const firmware_header_t *header, const uint8_t *image);
+
+#endif /* IMAGE_LZ4_H */
@@ -0,0 +1,123 @@
+/**
+ * @file image_merkle.h
+ * @brief Segmented (Merkle) Firmware Images with Lazy Verification
+ * 
+ * Images flagged FIRMWARE_FLAG_MERKLE carry, right after the header, a
+ * segment descriptor and one SHA-256 leaf hash per fixed-size segment.
+ * header->hash holds the Merkle root over the leaves, which the signature
+ * covers through firmware_header_digest(). Boot verifies the root plus the segments holding the
+ * vector table and entry point; every other segment stays blocked for
+ * Non-Secure access until it is verified in the background or on the
+ * first access fault.
+ * 
+ * Slot layout: firmware_header_t | image_merkle_ext_t | leaves | image
+ * 
+ * Images execute in place, so load_address must be the slot address of
+ * the image data. The leaf table is copied to Secure RAM before the root
+ * is computed; Non-Secure writes to the slot cannot swap it afterwards.
+ */
+
+#ifndef IMAGE_MERKLE_H
+#define IMAGE_MERKLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "secure_boot.h"
+#include "sha256.h"
+
+/* Segment geometry */
+#define IMAGE_MERKLE_SEGMENT_LOG2_MIN   12      /* 4KB */
+#define IMAGE_MERKLE_SEGMENT_LOG2_MAX   16      /* 64KB */
+#define IMAGE_MERKLE_MAX_SEGMENTS       (FIRMWARE_MAX_IMAGE_SIZE >> IMAGE_MERKLE_SEGMENT_LOG2_MIN)
+
+/* Domain separation prefixes so a leaf can never pass as a node */
+#define IMAGE_MERKLE_LEAF_PREFIX        0x00
+#define IMAGE_MERKLE_NODE_PREFIX        0x01
+
+/* Segment Descriptor (follows firmware_header_t) */
+typedef struct __attribute__((packed)) {
+    uint32_t segment_log2;       /* log2 of segment size */
+    uint32_t segment_count;      /* Number of leaves that follow */
+} image_merkle_ext_t;
+
+/**
+ * @brief Compute the image digest the signature covers
+ * @param header Firmware header
+ * @param image Bytes following the header in the slot
+ * @param digest Output (SHA256_DIGEST_SIZE bytes)
+ * @return true if computed
+ * 
+ * Flat images are hashed in full. Merkle images only hash the leaf table
+ * to the root, and arm lazy verification for their segments. LZ4 images
+ * are decompressed to load_address and hashed in the same pass.
+ */
+bool firmware_image_digest(const firmware_header_t *header, const uint8_t *image,
+                           uint8_t *digest);
+
+/**
+ * @brief Get the start of executable image data
+ * @param header Firmware header
+ * @param image Bytes following the header in the slot
+ * @return Pointer to image data (past the leaf table for Merkle images,
+ *         load_address for LZ4 images)
+ */
+const uint8_t *firmware_image_data(const firmware_header_t *header, const uint8_t *image);
+
+/**
+ * @brief Get the bytes the image occupies in the slot after the header
+ * @param header Firmware header
+ * @param image Bytes following the header in the slot
+ * @return uint32_t Stored extent per image format, or 0 if malformed
+ * 
+ * Covers the Merkle descriptor and leaf table, or the LZ4 descriptor and
+ * compressed stream, rather than the image_size the hash describes.
+ */
+uint32_t firmware_image_stored_size(const firmware_header_t *header, const uint8_t *image);
+
+/**
+ * @brief Get the bytes a Merkle image occupies after the header
+ * @param header Firmware header (FIRMWARE_FLAG_MERKLE)
+ * @param image Bytes following the header in the slot
+ * @return uint32_t Descriptor + leaf table + image_size, or 0 if malformed
+ */
+uint32_t image_merkle_stored_size(const firmware_header_t *header, const uint8_t *image);
+
+/**
+ * @brief Verify the segments needed to start executing
+ * @param header Firmware header (root already verified)
+ * @return true if vector table and entry point segments verified
+ */
+bool image_merkle_verify_boot_segments(const firmware_header_t *header);
+
+/**
+ * @brief Verify one segment and open it for Non-Secure access
+ * @param index Segment index
+ * @return true if the segment matches its leaf
+ */
+bool image_merkle_verify_segment(uint32_t index);
+
+/**
+ * @brief Verify pending segments in the background
+ * @param max_segments Most segments to verify in this call
+ * @return uint32_t Segments still unverified
+ */
+uint32_t image_merkle_verify_pending(uint32_t max_segments);
+
+/**
+ * @brief Resolve an access fault on a blocked segment
+ * @param fault_address Faulting address
+ * @return true if the segment verified and the access may be retried
+ * 
+ * Call from SecureFault/BusFault; false means the address is not in the
+ * image or the segment was modified, and the caller must treat it as tamper.
+ */
+bool image_merkle_fault_handler(uint32_t fault_address);
+
+/**
+ * @brief Check whether a segment is open for Non-Secure access
+ * @param index Segment index
+ * @return true if verified
+ */
+bool image_merkle_segment_verified(uint32_t index);
+
+#endif /* IMAGE_MERKLE_H */
@@ -0,0 +1,68 @@
+/**
+ * @file jitter.h
+ * @brief Budgeted Random Jitter Scheduler
+ * 
+ * Distributes a fixed per-boot cycle budget randomly across jitter call
+ * sites. Every call still receives an unpredictable delay for glitch
+ * desynchronization, but total jitter is bounded so worst-case boot
+ * latency fits the watchdog window.
+ */
+
+#ifndef JITTER_H
+#define JITTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Approximate cost of one jitter delay-loop iteration on Cortex-M33 */
+#define JITTER_CYCLES_PER_ITERATION 8
+
+/* Jitter Profiles */
+typedef enum {
+    JITTER_PROFILE_FACTORY = 0,  /* Fast boot for production line/test */
+    JITTER_PROFILE_FIELD,        /* Hardened boot for deployed devices */
+    JITTER_PROFILE_COUNT
+} jitter_profile_t;
+
+/* Profile selected at boot unless overridden */
+#ifndef JITTER_DEFAULT_PROFILE
+#define JITTER_DEFAULT_PROFILE  JITTER_PROFILE_FIELD
+#endif
+
+/* Jitter Profile Parameters (all values in CPU cycles) */
+typedef struct {
+    uint32_t budget_cycles;      /* Total jitter per boot */
+    uint32_t min_cycles;         /* Guaranteed floor per call */
+    uint32_t max_cycles;         /* Cap per call */
+    uint32_t expected_calls;     /* Call sites the budget is spread over */
+} jitter_profile_config_t;
+
+/**
+ * @brief Select jitter profile and reset the per-boot budget
+ * @param profile Profile to use
+ * @return true if profile valid
+ */
+bool jitter_set_profile(jitter_profile_t profile);
+
+/**
+ * @brief Reset the per-boot budget for the current profile
+ */
+void jitter_budget_reset(void);
+
+/**
+ * @brief Draw the delay for one jitter call site from the budget
+ * @param random Random word from TRNG
+ * @return uint32_t Delay in CPU cycles
+ * 
+ * Calls beyond expected_calls receive at most min_cycles, so the
+ * worst case per boot is budget_cycles plus min_cycles per extra call.
+ */
+uint32_t jitter_budget_draw(uint32_t random);
+
+/**
+ * @brief Get remaining jitter budget for this boot
+ * @return uint32_t Remaining cycles
+ */
+uint32_t jitter_budget_remaining(void);
+
+#endif /* JITTER_H */
@@ -11,12 +11,17 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "boot_sched.h"
 
 /* Key sizes */
 #define PUF_KEY_SIZE            32   /* 256-bit key */
 #define WRAPPED_KEY_SIZE        48   /* Wrapped key with metadata */
 #define KEY_DERIVATION_SALT_SIZE 16  /* Salt for key derivation */
 
+/* Unwrap commands queued per Secure Vault mailbox submission */
+#define PUF_UNWRAP_BATCH_MAX    8
+
 /* Key Types */
 typedef enum {
     KEY_TYPE_ENCRYPTION = 0x01,
@@ -60,6 +65,48 @@ bool puf_enroll(void);
  */
 bool puf_reconstruct_key(uint8_t *key_output, uint32_t key_size);
 
+/**
+ * @brief Open a PUF session
+ * @return true if the root key is available for the session
+ * 
+ * Reconstructs the PUF root key once and keeps it in a locked Secure
+ * RAM slot so that derivations, wraps and unwraps inside the session do
+ * not each trigger a full reconstruction. Sessions nest; the key is
+ * zeroized when the outermost session closes. Returns false while a
+ * puf_session_open_step() job is in flight: join that job instead.
+ */
+bool puf_session_open(void);
+
+/**
+ * @brief Open a PUF session without waiting on the Secure Vault
+ * @param ctx Unused (boot_job_step_t signature)
+ * @return boot_job_status_t PENDING while the reconstruction is in flight
+ * 
+ * Submit with boot_sched_submit(); on DONE the session is open exactly as
+ * after puf_session_open() and is closed with puf_session_close().
+ */
+boot_job_status_t puf_session_open_step(void *ctx);
+
+/**
+ * @brief Close a PUF session
+ */
+void puf_session_close(void);
+
+/**
+ * @brief Zeroize the session root key immediately, regardless of nesting
+ * 
+ * Called from the tamper response path. A puf_session_open_step() job in
+ * flight is cancelled, even mid-reconstruction: the key is held in
+ * scratch and committed with interrupts masked only if no zeroize ran.
+ */
+void puf_session_zeroize(void);
+
+/**
+ * @brief Check if a PUF session is open
+ * @return true if the root key is cached
+ */
+bool puf_session_active(void);
+
 /**
  * @brief Derive key from PUF with additional context
  * @param context Context string for key derivation
@@ -92,6 +139,18 @@ bool puf_wrap_key(const uint8_t *plaintext_key, uint32_t key_size,
 bool puf_unwrap_key(const wrapped_key_t *wrapped, uint8_t *plaintext_key, 
                     uint32_t key_size);
 
+/**
+ * @brief Unwrap multiple keys with a single wrapping key derivation
+ * @param wrapped Array of wrapped key structures
+ * @param count Number of wrapped keys
+ * @param plaintext_keys Output buffer (count * key_size bytes)
+ * @param key_size Size of each unwrapped key
+ * @param status Per-key result array (count entries)
+ * @return Number of keys unwrapped successfully
+ */
+uint32_t puf_unwrap_keys(const wrapped_key_t *wrapped, size_t count,
+                         uint8_t *plaintext_keys, uint32_t key_size, bool *status);
+
 /**
  * @brief Zeroize key material from memory
  * @param key Pointer to key buffer
@@ -0,0 +1,36 @@
+/**
+ * @file ramfunc.h
+ * @brief RAM-Resident Hot Paths
+ * 
+ * RAMFUNC places a function in the .ramfunc section, which the linker
+ * script (config/efr32mg26_secure.ld) loads into Secure flash and links
+ * at the start of Secure RAM. ramfunc_init() copies it there before any
+ * of those functions run. Zero-wait-state SRAM keeps the hash and field
+ * arithmetic loops and the tamper ISRs off flash wait states and cache
+ * misses. `make` lists the RAM cost of each function after linking.
+ * 
+ * Host builds compile RAMFUNC away.
+ */
+
+#ifndef RAMFUNC_H
+#define RAMFUNC_H
+
+#include <stdint.h>
+
+/* Calls between flash and RAM (more than 16MB apart) go through
+ * linker-generated long-branch veneers */
+#if defined(__ARM_ARCH_8M_MAIN__)
+#define RAMFUNC     __attribute__((section(".ramfunc"), noinline))
+#else
+#define RAMFUNC
+#endif
+
+/**
+ * @brief Copy .ramfunc from its flash load address to Secure RAM
+ * 
+ * Call first thing in main(), before interrupts are enabled: the tamper
+ * IRQ handlers live in .ramfunc.
+ */
+void ramfunc_init(void);
+
+#endif /* RAMFUNC_H */
@@ -31,6 +31,23 @@
 #define FIRMWARE_VERSION_MINOR  0
 #define FIRMWARE_VERSION_PATCH  0
 
+/* Image carries a segment leaf table; hash is the Merkle root (image_merkle.h) */
+#define FIRMWARE_FLAG_MERKLE        (1UL << 0)
+
+/* Image is an LZ4 block stream, loaded to load_address at boot (image_lz4.h) */
+#define FIRMWARE_FLAG_LZ4           (1UL << 1)
+
+/* Security epoch carried in the top byte of firmware_header_t.flags */
+#define FIRMWARE_FLAGS_EPOCH_SHIFT  24
+#define FIRMWARE_FLAGS_EPOCH_MASK   0xFF000000
+#define FIRMWARE_SECURITY_EPOCH(flags) \
+    (((flags) & FIRMWARE_FLAGS_EPOCH_MASK) >> FIRMWARE_FLAGS_EPOCH_SHIFT)
+
+/* Firmware Image Slot (Non-Secure flash, header followed by image) */
+#define FIRMWARE_IMAGE_MAGIC    0x464D5750  /* "FWPG" magic */
+#define FIRMWARE_SLOT_ADDRESS   0x00040000  /* Non-Secure flash base */
+#define FIRMWARE_MAX_IMAGE_SIZE 0x100000
+
 /* Boot Status Codes */
 typedef enum {
     BOOT_STATUS_INIT = 0x11223344,
@@ -47,7 +64,7 @@ typedef struct __attribute__((packed)) {
     uint32_t image_size;         /* Size of firmware image */
     uint32_t load_address;       /* Load address in memory */
     uint32_t entry_point;        /* Entry point address */
-    uint8_t signature[64];       /* ECDSA signature */
+    uint8_t signature[64];       /* ECDSA P-256 r || s over the header digest */
     uint8_t hash[32];            /* SHA-256 hash of image */
     uint32_t timestamp;          /* Build timestamp */
     uint32_t flags;              /* Security flags */
@@ -78,23 +95,38 @@ uint32_t verify_layered_tokens(boot_context_t *context);
 /**
  * @brief Inject random jitter delay for timing desynchronization
  * @param seed Random seed from TRNG
+ * 
+ * The delay is drawn from the per-boot budget of the active jitter
+ * profile (see jitter.h).
  */
 void inject_random_jitter(uint32_t seed);
 
 /**
- * @brief Verify firmware signature using ECDSA
+ * @brief Verify firmware image hash and ECDSA signature
  * @param header Pointer to firmware header
- * @param image Pointer to firmware image
+ * @param image Pointer to firmware image (header->image_size bytes)
  * @return uint32_t Verification result (non-binary token)
  */
 uint32_t verify_firmware_signature(const firmware_header_t *header, const uint8_t *image);
 
 /**
- * @brief Check anti-rollback version
+ * @brief Compute the digest the header signature covers
+ * @param header Pointer to firmware header
+ * @param digest Output buffer (32 bytes)
+ * 
+ * SHA-256 over every header field but signature, in layout order, so
+ * version, flags (security epoch, image format), load_address,
+ * entry_point and timestamp are signed along with the image hash.
+ */
+void firmware_header_digest(const firmware_header_t *header, uint8_t *digest);
+
+/**
+ * @brief Check anti-rollback version and security epoch
  * @param new_version Version to check
+ * @param security_epoch Security epoch from the header flags
  * @return uint32_t Verification result token
  */
-uint32_t check_anti_rollback(uint32_t new_version);
+uint32_t check_anti_rollback(uint32_t new_version, uint32_t security_epoch);
 
 /**
  * @brief Execute secure boot sequence
@@ -102,4 +134,24 @@ uint32_t check_anti_rollback(uint32_t new_version);
  */
 boot_status_t execute_secure_boot(void);
 
+/**
+ * @brief Copy the boot context of a completed boot
+ * @param context Pointer to receive the context
+ * @return true if the last boot succeeded and the context was copied
+ */
+bool secure_boot_get_context(boot_context_t *context);
+
+/**
+ * @brief Resume from a sealed boot context after EM4
+ * @param context Authenticated context from before EM4 entry
+ * @param header Firmware header of the slot
+ * @param image Firmware image (header->image_size bytes)
+ * @return boot_status_t BOOT_STATUS_SUCCESS, or BOOT_STATUS_FAILURE to force a full boot
+ * 
+ * Requires the anti-rollback shadow to be resumed first
+ * (anti_rollback_resume()). Used by warm_resume_restore().
+ */
+boot_status_t secure_boot_resume(const boot_context_t *context,
+                                 const firmware_header_t *header, const uint8_t *image);
+
 #endif /* SECURE_BOOT_H */
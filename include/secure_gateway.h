@@ -0,0 +1,89 @@
+/**
+ * @file secure_gateway.h
+ * @brief Secure Gateway Call Dispatcher
+ * 
+ * Routes Non-Secure calls to Secure handlers through a dispatch table
+ * indexed by function_id, behind a small fixed set of NSC entry points.
+ * Multiple requests can be queued in a shared Non-Secure ring and
+ * serviced in a single Secure entry. Buffer arguments are validated in
+ * place and handed to the handler without copying.
+ */
+
+#ifndef SECURE_GATEWAY_H
+#define SECURE_GATEWAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "trustzone.h"
+
+/* Request ring capacity (power of two) */
+#define SG_RING_SIZE                16
+
+/* Dispatcher Status Codes (handler results are passed through) */
+#define SG_STATUS_OK                0
+#define SG_STATUS_INVALID_FUNCTION  (-1)   /* Unknown or disabled function_id */
+#define SG_STATUS_INVALID_ARGUMENT  (-2)   /* Buffer not entirely Non-Secure */
+
+/* Non-Secure Callable entry attribute (SG veneer emitted by the linker) */
+#if defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE & 2)
+#define SG_NSC_ENTRY    __attribute__((cmse_nonsecure_entry))
+#else
+#define SG_NSC_ENTRY
+#endif
+
+/* Gateway Request (one ring slot) */
+typedef struct {
+    uint32_t function_id;        /* Dispatch table index */
+    uint32_t buffer;             /* Non-Secure buffer address, or 0 */
+    uint32_t length;             /* Buffer length in bytes */
+    uint32_t arg;                /* Scalar argument */
+    int32_t result;              /* Written by Secure world */
+} sg_request_t;
+
+/* Shared Request Ring (lives in Non-Secure RAM) */
+typedef struct {
+    volatile uint32_t head;      /* Written by Non-Secure: requests submitted */
+    volatile uint32_t tail;      /* Written by Secure: requests completed */
+    sg_request_t requests[SG_RING_SIZE];
+} sg_request_ring_t;
+
+/**
+ * @brief Clear the dispatch table and detach any request ring
+ */
+void secure_gateway_reset(void);
+
+/**
+ * @brief Install a gateway handler in the dispatch table
+ * @param gateway Gateway configuration
+ * @return true if installed (disabled gateways are accepted and skipped)
+ */
+bool secure_gateway_bind(const secure_gateway_t *gateway);
+
+/**
+ * @brief Call one Secure function (NSC entry)
+ * @param function_id Function identifier
+ * @param buffer Non-Secure buffer, or NULL
+ * @param length Buffer length in bytes
+ * @param arg Scalar argument
+ * @return int32_t Handler result or SG_STATUS_* error
+ */
+SG_NSC_ENTRY int32_t secure_gateway_call(uint32_t function_id, void *buffer,
+                                         uint32_t length, uint32_t arg);
+
+/**
+ * @brief Attach the shared request ring (NSC entry)
+ * @param ring Ring in Non-Secure RAM, or NULL to detach
+ * @return true if ring attached or detached
+ */
+SG_NSC_ENTRY bool secure_gateway_attach_ring(sg_request_ring_t *ring);
+
+/**
+ * @brief Service all pending ring requests (NSC entry)
+ * @return uint32_t Number of requests completed
+ * 
+ * Each request's result is written back to its slot before the tail is
+ * advanced past it.
+ */
+SG_NSC_ENTRY uint32_t secure_gateway_process_ring(void);
+
+#endif /* SECURE_GATEWAY_H */
@@ -0,0 +1,56 @@
+/**
+ * @file sha256.h
+ * @brief Incremental SHA-256 Implementation
+ * 
+ * Software SHA-256 used as the CPU fallback for image hashing and by
+ * any component that needs a digest without a Secure Vault round-trip.
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Digest and block sizes */
+#define SHA256_DIGEST_SIZE      32
+#define SHA256_BLOCK_SIZE       64
+
+/* SHA-256 Streaming Context */
+typedef struct {
+    uint32_t state[8];                   /* Intermediate hash value */
+    uint64_t total_len;                  /* Total bytes absorbed */
+    uint8_t block[SHA256_BLOCK_SIZE];    /* Pending partial block */
+    uint32_t block_len;                  /* Bytes in pending block */
+} sha256_context_t;
+
+/**
+ * @brief Initialize SHA-256 context
+ * @param ctx Pointer to context
+ */
+void sha256_init(sha256_context_t *ctx);
+
+/**
+ * @brief Absorb data into SHA-256 context
+ * @param ctx Pointer to context
+ * @param data Data to hash
+ * @param len Length of data
+ */
+void sha256_update(sha256_context_t *ctx, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Finalize SHA-256 and output digest
+ * @param ctx Pointer to context (cleared on return)
+ * @param digest Output buffer (SHA256_DIGEST_SIZE bytes)
+ */
+void sha256_final(sha256_context_t *ctx, uint8_t *digest);
+
+/**
+ * @brief Compute SHA-256 of a single buffer
+ * @param data Data to hash
+ * @param len Length of data
+ * @param digest Output buffer (SHA256_DIGEST_SIZE bytes)
+ */
+void sha256_compute(const uint8_t *data, uint32_t len, uint8_t *digest);
+
+#endif /* SHA256_H */
@@ -3,7 +3,9 @@
  * @brief Active Tamper Detection using ACMP/IADC peripherals for EFR32MG26
  * 
  * Implements preemptive anti-tamper monitoring for voltage and temperature
- * anomalies with immediate response capabilities.
+ * anomalies with immediate response capabilities. Detection is fully
+ * interrupt driven: ACMP edges and the IADC window comparator raise
+ * events, so the core can stay in EM2 between samples.
  */
 
 #ifndef TAMPER_DETECTION_H
@@ -11,6 +13,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "boot_sched.h"
 
 /* Tamper Event Types */
 #define TAMPER_EVENT_NONE           0x00000000
@@ -21,6 +24,9 @@
 #define TAMPER_EVENT_GLITCH         0x00000010
 #define TAMPER_EVENT_CLOCK_ANOMALY  0x00000020
 
+/* Attestation event type used when logging tamper events */
+#define TAMPER_LOG_EVENT_TYPE       0x00000020
+
 /* Voltage Thresholds (in millivolts) */
 #define VOLTAGE_THRESHOLD_LOW_MV    2700
 #define VOLTAGE_THRESHOLD_HIGH_MV   3600
@@ -31,6 +37,44 @@
 #define TEMP_THRESHOLD_HIGH_C       85
 #define TEMP_NOMINAL_C              25
 
+/* Tamper Response Configuration */
+#define TAMPER_SECRET_REGION_MAX    8            /* Registered secret regions */
+#define TAMPER_RECORD_MAGIC         0x54414D50   /* "TAMP" */
+
+/* Events that wipe secrets and persist a record */
+#define TAMPER_TIER_WIPE_EVENTS     (TAMPER_EVENT_VOLTAGE_LOW | TAMPER_EVENT_VOLTAGE_HIGH | \
+                                     TAMPER_EVENT_TEMP_LOW | TAMPER_EVENT_TEMP_HIGH)
+
+/* Events that additionally force an immediate reset */
+#define TAMPER_TIER_RESET_EVENTS    (TAMPER_EVENT_GLITCH | TAMPER_EVENT_CLOCK_ANOMALY)
+
+/* Supply Sample Buffering (IADC scan -> LDMA circular buffer) */
+#define TAMPER_SAMPLE_BUFFER_SIZE   64   /* Samples; processed per half */
+#define TAMPER_SAMPLE_BLOCK_SIZE    (TAMPER_SAMPLE_BUFFER_SIZE / 2)
+#define TAMPER_SLEW_LIMIT_MV        200  /* Max change between adjacent samples */
+#define TAMPER_DEVIATION_LIMIT_MV   250  /* Max excursion from running mean */
+
+/* Tamper Response Tiers */
+typedef enum {
+    TAMPER_TIER_NONE = 0,        /* No action */
+    TAMPER_TIER_WIPE,            /* Zeroize secrets, persist record, continue */
+    TAMPER_TIER_RESET            /* Wipe, persist, then reset or enter EM4 */
+} tamper_tier_t;
+
+/* Reset Action for TAMPER_TIER_RESET */
+typedef enum {
+    TAMPER_RESET_SYSRESETREQ = 0,  /* Immediate software reset (AIRCR) */
+    TAMPER_RESET_EM4               /* Drop to EM4 until external wakeup */
+} tamper_reset_action_t;
+
+/* Persisted Tamper Record (retained across reset and EM4 in BURAM) */
+typedef struct {
+    uint32_t magic;              /* TAMPER_RECORD_MAGIC when valid */
+    uint32_t event_flags;        /* Events that triggered the response */
+    uint32_t event_count;        /* Total tamper events at response time */
+    uint32_t check;              /* ~(magic ^ event_flags ^ event_count) */
+} tamper_record_t;
+
 /* ACMP Configuration Structure */
 typedef struct {
     uint32_t low_threshold;      /* Low voltage threshold */
@@ -45,8 +89,19 @@ typedef struct {
     uint32_t temp_low_threshold; /* Low temperature threshold */
     uint32_t temp_high_threshold;/* High temperature threshold */
     bool continuous_mode;        /* Continuous monitoring mode */
+    bool supply_scan;            /* LDMA-buffered supply voltage scan */
 } iadc_config_t;
 
+/* Windowed Supply Statistics (one processed block) */
+typedef struct {
+    uint32_t mean_mv;            /* Block mean */
+    uint32_t min_mv;             /* Block minimum */
+    uint32_t max_mv;             /* Block maximum */
+    uint32_t max_slew_mv;        /* Largest adjacent-sample change */
+    uint32_t running_mean_mv;    /* Mean across blocks (EWMA) */
+    uint32_t blocks;             /* Blocks processed */
+} tamper_window_stats_t;
+
 /* Tamper Context */
 typedef struct {
     uint32_t event_flags;        /* Bitmap of tamper events */
@@ -77,26 +132,113 @@ bool iadc_init(const iadc_config_t *config);
  */
 bool tamper_detection_start(tamper_context_t *context);
 
+/**
+ * @brief Wait for the first IADC temperature conversion without blocking
+ * @param ctx Unused (boot_job_step_t signature)
+ * @return boot_job_status_t PENDING during IADC warmup, FAILED if the
+ *         first sample is outside the temperature window
+ * 
+ * tamper_detection_start() returns as soon as the peripherals are
+ * configured; submit this with boot_sched_submit() so the boot decision
+ * is not taken before temperature monitoring is live.
+ */
+boot_job_status_t tamper_warmup_step(void *ctx);
+
 /**
  * @brief Check for tamper events
  * @param context Pointer to tamper context
  * @return uint32_t Bitmap of detected tamper events
+ * 
+ * Returns the events latched by the interrupt handlers since the last
+ * call and clears them; no peripheral is read. The handlers have already
+ * run execute_tamper_response() for each event.
  */
 uint32_t check_tamper_events(tamper_context_t *context);
 
+/**
+ * @brief Get the number of tamper events since tamper_detection_start()
+ * @return uint32_t Event count
+ * 
+ * Unlike check_tamper_events() this consumes nothing, so boot code can
+ * sample it without hiding events from the application.
+ */
+uint32_t tamper_event_count(void);
+
 /**
  * @brief Execute anti-tamper response
  * @param event_flags Bitmap of tamper events
+ * 
+ * Wipe-tier events zeroize the PUF key cache and all registered secret
+ * regions and persist a tamper record, then return. Reset-tier events
+ * do the same and then reset immediately (or enter EM4) instead of
+ * waiting for the watchdog; on target this does not return.
  */
 void execute_tamper_response(uint32_t event_flags);
 
+/**
+ * @brief Register a memory region to zeroize on tamper
+ * @param base Region start
+ * @param length Region length in bytes
+ * @return true if registered (or already registered)
+ * 
+ * Modules register the Secure RAM secrets they own from their init
+ * function; puf_init() registers the session key slot.
+ */
+bool tamper_register_secret(void *base, uint32_t length);
+
+/**
+ * @brief Select the reset-tier action
+ * @param action Reset or EM4 entry
+ */
+void tamper_set_reset_action(tamper_reset_action_t action);
+
+/**
+ * @brief Get the response tier for a set of events
+ * @param event_flags Bitmap of tamper events
+ * @return tamper_tier_t Highest tier required
+ */
+tamper_tier_t tamper_classify_events(uint32_t event_flags);
+
+/**
+ * @brief Read the tamper record persisted before the last reset
+ * @param record Pointer to receive record
+ * @return true if a valid record exists
+ */
+bool tamper_get_last_record(tamper_record_t *record);
+
+/**
+ * @brief Clear the persisted tamper record
+ */
+void tamper_clear_record(void);
+
+/**
+ * @brief Get statistics of the most recent supply sample block
+ * @param stats Pointer to receive statistics
+ * @return true if at least one block has been processed
+ */
+bool tamper_get_window_stats(tamper_window_stats_t *stats);
+
+/**
+ * @brief LDMA half-buffer interrupt handler for supply samples
+ * 
+ * Called from the LDMA interrupt when the tamper channel has filled one
+ * half of the sample buffer; processes that block while LDMA fills the
+ * other half.
+ */
+void iadc_dma_irq_handler(void);
+
 /**
  * @brief ACMP interrupt handler for voltage glitch detection
+ * 
+ * Evaluates only the supply comparators (ACMP0 undervoltage, ACMP1
+ * overvoltage).
  */
 void acmp_irq_handler(void);
 
 /**
  * @brief IADC interrupt handler for temperature anomaly detection
+ * 
+ * Runs only when a sample falls outside the CMPTHR window.
  */
 void iadc_irq_handler(void);
 
@@ -16,6 +16,27 @@
 #define REGION_TYPE_SECURE      0x00
 #define REGION_TYPE_NON_SECURE  0x01
 
+/* SAU geometry (EFR32MG26: 8 regions, 32-byte granule) */
+#define SAU_REGION_MAX          8
+#define SAU_REGION_ALIGN        32U
+#define SAU_RLAR_ENABLE         (1UL << 0)
+#define SAU_RLAR_NSC            (1UL << 1)
+
+/* Secure gateway function IDs are 0 .. TZ_MAX_GATEWAYS - 1 */
+#define TZ_MAX_GATEWAYS         16
+
+/* Non-Secure intervals held by the address classification table */
+#define TZ_NS_INTERVAL_MAX      8
+
+/* Fill pattern used to find the secure stack high-water mark */
+#define TZ_STACK_PAINT_PATTERN  0x5AFE57ACUL
+
+/* Classify addresses with the TT instruction instead of the table
+ * (requires a Secure CMSE build, -mcmse) */
+#ifndef TZ_CLASSIFY_USE_TT
+#define TZ_CLASSIFY_USE_TT      0
+#endif
+
 /* SAU Region Configuration */
 typedef struct {
     uint32_t start_address;      /* Region start address */
@@ -24,10 +45,38 @@ typedef struct {
     bool enable;                 /* Region enabled */
 } sau_region_config_t;
 
+/* Raw SAU Region Programming Words */
+typedef struct {
+    uint32_t rnr;                /* Region number */
+    uint32_t rbar;               /* Base address */
+    uint32_t rlar;               /* Limit address | NSC | ENABLE */
+} sau_region_words_t;
+
+/* Compile-time check: evaluates to 0, or fails to build if cond is false */
+#define SAU_STATIC_CHECK(cond)  (0 * sizeof(char[(cond) ? 1 : -1]))
+
+/**
+ * Static initializer for one SAU region covering [start, end). The region
+ * is Non-Secure, or Non-Secure Callable if nsc is true; Secure memory is not
+ * programmed since the SAU attributes unmapped addresses as Secure.
+ * Bounds, alignment and region number are checked at compile time.
+ */
+#define SAU_REGION_WORDS(num, start, end, nsc) {                            \
+    (uint32_t)(num) + SAU_STATIC_CHECK((num) < SAU_REGION_MAX),             \
+    (uint32_t)(start) + SAU_STATIC_CHECK((start) % SAU_REGION_ALIGN == 0),  \
+    (((uint32_t)(end) - 1U) & ~(SAU_REGION_ALIGN - 1U)) |                   \
+        ((nsc) ? SAU_RLAR_NSC : 0U) | SAU_RLAR_ENABLE |                     \
+        SAU_STATIC_CHECK((end) % SAU_REGION_ALIGN == 0 && (end) > (start))  \
+}
+
+/* Secure gateway implementation; buffer is already validated as Non-Secure */
+typedef int32_t (*secure_gateway_fn_t)(void *buffer, uint32_t length, uint32_t arg);
+
 /* Secure Gateway Configuration */
 typedef struct {
     uint32_t gateway_address;    /* Secure gateway entry point */
-    uint32_t function_id;        /* Function identifier */
+    uint32_t function_id;        /* Function identifier (dispatch table index) */
+    secure_gateway_fn_t handler; /* Secure implementation */
     bool enabled;                /* Gateway enabled */
 } secure_gateway_t;
 
@@ -39,7 +88,9 @@ typedef struct {
     sau_region_config_t ram_non_secure;    /* Non-secure RAM region */
     sau_region_config_t peripheral_secure; /* Secure peripherals */
     uint32_t gateway_count;                /* Number of secure gateways */
-    secure_gateway_t gateways[16];         /* Secure gateway entries */
+    secure_gateway_t gateways[TZ_MAX_GATEWAYS]; /* Secure gateway entries */
+    const sau_region_words_t *sau_words;   /* Precomputed SAU blob, or NULL */
+    uint32_t sau_word_count;               /* Regions in sau_words */
 } trustzone_config_t;
 
 /**
@@ -49,6 +100,32 @@ typedef struct {
  */
 bool trustzone_init(const trustzone_config_t *config);
 
+/**
+ * @brief Rebuild TrustZone state after an EM4 warm resume
+ * @param config TrustZone configuration
+ * @return true if restored
+ * 
+ * Same as trustzone_init() except that the SAU is left as programmed:
+ * warm_resume_restore() has already applied the sealed pre-EM4 regions.
+ */
+bool trustzone_resume(const trustzone_config_t *config);
+
+/**
+ * @brief Drop the TrustZone RAM state ahead of EM4 entry
+ * 
+ * Clears the classification and gateway tables so that only
+ * trustzone_resume() or trustzone_init() can bring them back. The SAU
+ * itself is left programmed.
+ */
+void trustzone_suspend(void);
+
+/**
+ * @brief Get the SAU words programmed by trustzone_init()
+ * @param words Receives the region words
+ * @return uint32_t Number of regions, or 0 if the SAU was set up per region
+ */
+uint32_t trustzone_get_sau_words(const sau_region_words_t **words);
+
 /**
  * @brief Configure SAU region
  * @param region_number SAU region number (0-7)
@@ -57,6 +134,17 @@ bool trustzone_init(const trustzone_config_t *config);
  */
 bool sau_configure_region(uint32_t region_number, const sau_region_config_t *config);
 
+/**
+ * @brief Program SAU regions from precomputed words
+ * @param words Region words built with SAU_REGION_WORDS()
+ * @param count Number of regions (at most SAU_REGION_MAX)
+ * @return true if applied
+ * 
+ * No per-region validation is done at runtime; regions not listed are
+ * left disabled. Used by trustzone_init() and on EM4 wakeup.
+ */
+bool sau_apply_words(const sau_region_words_t *words, uint32_t count);
+
 /**
  * @brief Enable SAU
  * @return true if SAU enabled successfully
@@ -67,21 +155,59 @@ bool sau_enable(void);
  * @brief Register secure gateway function
  * @param gateway Gateway configuration
  * @return true if gateway registered successfully
+ * 
+ * Installs the handler in the dispatch table behind secure_gateway_call();
+ * fails if the function ID is out of range or already registered.
  */
 bool register_secure_gateway(const secure_gateway_t *gateway);
 
+/**
+ * @brief Paint the unused secure stack for watermark tracking
+ * 
+ * Called from trustzone_init(); fills the stack below the current
+ * stack pointer with TZ_STACK_PAINT_PATTERN. Needs __StackLimit from the
+ * linker script; without it nothing is painted or scrubbed and the high
+ * water reads 0.
+ */
+void tz_stack_paint(void);
+
+/**
+ * @brief Get secure stack high-water usage
+ * @return uint32_t Bytes of secure stack touched since tz_stack_paint()
+ */
+uint32_t tz_stack_high_water(void);
+
 /**
  * @brief Transition to Non-Secure state
- * @param ns_reset_handler Non-Secure reset handler address
- * @param ns_stack_pointer Non-Secure stack pointer
+ * @param ns_vector_table Non-Secure vector table (initial MSP, reset handler)
+ * @return false if the vector table or its entries are not Non-Secure;
+ *         does not return on success
+ * 
+ * Scrubs only the secure stack used since tz_stack_paint(), enables lazy
+ * FP state preservation, then sets VTOR_NS, MSP_NS and CONTROL_NS in one
+ * sequence before branching with BLXNS.
  */
-void transition_to_nonsecure(uint32_t ns_reset_handler, uint32_t ns_stack_pointer);
+bool transition_to_nonsecure(uint32_t ns_vector_table);
 
 /**
  * @brief Check if address is in Secure region
  * @param address Address to check
  * @return true if address is secure
+ * 
+ * Constant time. As with the SAU, an address is Non-Secure only if an
+ * enabled Non-Secure region covers it and no Secure region does.
  */
 bool is_address_secure(uint32_t address);
 
+/**
+ * @brief Check if any part of an address range is Secure
+ * @param address Range start address
+ * @param length Range length in bytes (0 checks the start address only)
+ * @return true if any byte is secure or the range wraps past 4GB
+ * 
+ * Constant time. Secure gateways reject Non-Secure buffers for which
+ * this returns true.
+ */
+bool is_range_secure(uint32_t address, uint32_t length);
+
 #endif /* TRUSTZONE_H */
@@ -0,0 +1,106 @@
+/**
+ * @file verify_cache.h
+ * @brief Verified-Image Cache for Warm Boots
+ * 
+ * After a full verification succeeds, a PUF-keyed HMAC-SHA256 over the
+ * firmware header, the image hash and the OTP rollback state is kept in
+ * Secure storage. Later boots recompute only that MAC (plus, depending on
+ * the mode, the image hash) and skip signature verification when it
+ * matches. Any mismatch, flash write or rollback change invalidates it.
+ */
+
+#ifndef VERIFY_CACHE_H
+#define VERIFY_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "secure_boot.h"
+
+/* Cache record layout */
+#define VERIFY_CACHE_MAGIC      0x56434348  /* "VCCH" */
+#define VERIFY_CACHE_MAC_SIZE   32
+
+/* Flash page geometry used for the write-protect check */
+#define VERIFY_CACHE_PAGE_SIZE  8192
+#define VERIFY_CACHE_LOCK_WORDS 13          /* Covers 3.25MB of flash */
+
+/* Fast-Path Mode */
+typedef enum {
+    VERIFY_CACHE_MODE_REHASH = 0x01,     /* Re-hash image, skip signature only */
+    VERIFY_CACHE_MODE_WRITE_LOCK = 0x02  /* Trust slot page lock, skip hashing too */
+} verify_cache_mode_t;
+
+/* Mode used by execute_secure_boot() */
+#ifndef VERIFY_CACHE_DEFAULT_MODE
+#define VERIFY_CACHE_DEFAULT_MODE   VERIFY_CACHE_MODE_REHASH
+#endif
+
+/* Persisted Cache Record */
+typedef struct {
+    uint32_t magic;                       /* VERIFY_CACHE_MAGIC when valid */
+    uint32_t mode;                        /* Mode the record was written for */
+    uint8_t mac[VERIFY_CACHE_MAC_SIZE];   /* HMAC over header + OTP state */
+} verify_cache_record_t;
+
+/**
+ * @brief Check whether the image was verified on a previous boot
+ * @param header Firmware header
+ * @param image Firmware image (header->image_size bytes)
+ * @param mode Fast-path mode
+ * @return uint32_t TOKEN_STATE_ALL_VALID on a cache hit, else TOKEN_STATE_INVALID
+ */
+uint32_t verify_cache_check(const firmware_header_t *header, const uint8_t *image,
+                            verify_cache_mode_t mode);
+
+/**
+ * @brief Check whether a cache check needs the image digest
+ * @param header Firmware header
+ * @param mode Fast-path mode
+ * @return true unless a hit in this mode vouches for the image unhashed
+ * 
+ * When false, pass a NULL digest to verify_cache_check_digest() and skip
+ * hashing the slot on a hit. Always true for LZ4 images, which must be
+ * decompressed to load_address (by firmware_image_digest()) on every
+ * boot and warm resume, and for Merkle images, whose leaf table that
+ * pass arms for image_merkle_verify_boot_segments() and segment faults.
+ */
+bool verify_cache_needs_digest(const firmware_header_t *header, verify_cache_mode_t mode);
+
+/**
+ * @brief Check the cache against an image digest the caller already computed
+ * @param header Firmware header
+ * @param digest firmware_image_digest() of the slot (NULL if not needed)
+ * @param mode Fast-path mode
+ * @return uint32_t TOKEN_STATE_ALL_VALID on a cache hit, else TOKEN_STATE_INVALID
+ */
+uint32_t verify_cache_check_digest(const firmware_header_t *header, const uint8_t *digest,
+                                   verify_cache_mode_t mode);
+
+/**
+ * @brief Record a fully verified image
+ * @param header Firmware header that passed full verification
+ * @param mode Fast-path mode to allow on later boots
+ * @return true if the record was stored
+ */
+bool verify_cache_store(const firmware_header_t *header, verify_cache_mode_t mode);
+
+/**
+ * @brief Invalidate the cache
+ * 
+ * Must be called before any erase or write of the firmware slot.
+ */
+void verify_cache_invalidate(void);
+
+/**
+ * @brief Write-lock every flash page of the header and image
+ * @param header Firmware header, in place at the start of the slot
+ *        (the extent is firmware_image_stored_size())
+ * @return true if the whole slot reads back as locked
+ * 
+ * Page locks hold until reset, so with VERIFY_CACHE_MODE_WRITE_LOCK this
+ * runs on every boot before hand-off: Non-Secure code can then never
+ * write the slot, and Secure writers call verify_cache_invalidate().
+ */
+bool verify_cache_lock_slot(const firmware_header_t *header);
+
+#endif /* VERIFY_CACHE_H */
@@ -0,0 +1,93 @@
+/**
+ * @file warm_resume.h
+ * @brief EM4 Warm Resume from a Sealed Snapshot
+ * 
+ * Before EM4 entry the boot context, the SAU regions and the anti-rollback
+ * OTP shadow are sealed with a PUF-keyed HMAC-SHA256 into backup RAM
+ * (BURAM), the only memory EM4 retains. On wakeup the snapshot is checked
+ * and restored in one pass instead of running the full secure boot. A
+ * tamper record, a MAC mismatch or a changed image forces the full boot.
+ * Snapshots are single use: restore clears BURAM before checking it.
+ */
+
+#ifndef WARM_RESUME_H
+#define WARM_RESUME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "secure_boot.h"
+#include "anti_rollback.h"
+#include "trustzone.h"
+
+/* Snapshot layout */
+#define WARM_RESUME_MAGIC       0x57524D00  /* "WRM"; the low byte holds the SAU count */
+#define WARM_RESUME_MAGIC_MASK  0xFFFFFF00
+#define WARM_RESUME_MAC_SIZE    16          /* Truncated HMAC-SHA256 */
+#define WARM_RESUME_SAU_MAX     3           /* NS flash, NS RAM and NSC */
+
+/* Blob of precomputed SAU words that fits the snapshot (use in a static assert) */
+#define WARM_RESUME_SAU_FITS(words) \
+    ((sizeof(words) / sizeof((words)[0])) <= WARM_RESUME_SAU_MAX)
+
+/* BURAM geometry (Series 2: 32 retained words; RET[0..3] hold the tamper record) */
+#define WARM_RESUME_BURAM_FIRST 4
+#define WARM_RESUME_BURAM_WORDS 28
+
+/* Sealed SAU region: rbar is 32-byte aligned, so its low bits carry rnr */
+typedef struct {
+    uint32_t rbar_rnr;           /* RBAR | RNR */
+    uint32_t rlar;               /* Limit address | NSC | ENABLE */
+} warm_resume_sau_t;
+
+/* Sealed Snapshot (held word for word in BURAM) */
+typedef struct {
+    uint32_t magic;                                  /* WARM_RESUME_MAGIC | regions in sau */
+    boot_context_t context;                          /* Context of the completed boot */
+    uint32_t otp_shadow[ANTI_ROLLBACK_SHADOW_WORDS]; /* Anti-rollback RAM shadow */
+    warm_resume_sau_t sau[WARM_RESUME_SAU_MAX];      /* SAU regions in force */
+    uint8_t mac[WARM_RESUME_MAC_SIZE];               /* HMAC over the above + header */
+} warm_resume_snapshot_t;
+
+/**
+ * @brief Seal the running state into BURAM
+ * @param header Firmware header of the running image
+ * @return true if a snapshot was written
+ * 
+ * Call immediately before EM4 entry, after a successful boot. Fails
+ * (leaving no snapshot) on a tamper record or tamper events, or if the
+ * SAU was not programmed from precomputed words, or from more than
+ * WARM_RESUME_SAU_MAX of them.
+ */
+bool warm_resume_seal(const firmware_header_t *header);
+
+/**
+ * @brief Check and restore a sealed snapshot after EM4 wakeup
+ * @param tz_config TrustZone configuration (RAM state is rebuilt from it)
+ * @param header Firmware header of the slot
+ * @param image Firmware image (header->image_size bytes)
+ * @return uint32_t TOKEN_STATE_ALL_VALID if resumed, else TOKEN_STATE_INVALID
+ * 
+ * Requires puf_init() and puf_enroll(). On TOKEN_STATE_INVALID the caller runs the full
+ * trustzone_init() / execute_secure_boot() sequence.
+ */
+uint32_t warm_resume_restore(const trustzone_config_t *tz_config,
+                             const firmware_header_t *header, const uint8_t *image);
+
+/**
+ * @brief Discard any sealed snapshot
+ * 
+ * Must be called before any erase or write of the firmware slot, with
+ * verify_cache_invalidate().
+ */
+void warm_resume_invalidate(void);
+
+/**
+ * @brief Seal the snapshot and enter EM4
+ * @param header Firmware header of the running image
+ * 
+ * EM4 is entered even if sealing fails; the wakeup then takes the full
+ * boot. Does not return on target.
+ */
+void warm_resume_enter_em4(const firmware_header_t *header);
+
+#endif /* WARM_RESUME_H */
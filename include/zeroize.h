@@ -0,0 +1,50 @@
+/**
+ * @file zeroize.h
+ * @brief Fast Verified Memory Zeroization
+ * 
+ * Two paths: small buffers (keys, contexts) are cleared with aligned
+ * word and STM-multiple stores from the CPU; large regions (secure RAM
+ * wipes on tamper) are cleared by an LDMA memset and read back to prove
+ * the wipe completed. Both end with a barrier the compiler cannot elide.
+ */
+
+#ifndef ZEROIZE_H
+#define ZEROIZE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Regions at least this large use the LDMA path */
+#ifndef ZEROIZE_DMA_THRESHOLD
+#define ZEROIZE_DMA_THRESHOLD   1024
+#endif
+
+/* LDMA limit per descriptor (XFERCNT is 11 bits, in words) */
+#define ZEROIZE_DMA_MAX_WORDS   2048
+
+/**
+ * @brief Zeroize a buffer with CPU word-wide stores
+ * @param base Buffer start (any alignment)
+ * @param length Length in bytes
+ */
+void zeroize_fast(void *base, uint32_t length);
+
+/**
+ * @brief Zeroize a region and verify it reads back as zero
+ * @param base Region start (any alignment)
+ * @param length Length in bytes
+ * @return true if every byte reads back as zero
+ * 
+ * Uses LDMA for regions of ZEROIZE_DMA_THRESHOLD bytes or more.
+ */
+bool zeroize_region(void *base, uint32_t length);
+
+/**
+ * @brief Check that a region is all zero
+ * @param base Region start
+ * @param length Length in bytes
+ * @return true if all zero (constant time in length)
+ */
+bool zeroize_verify(const void *base, uint32_t length);
+
+#endif /* ZEROIZE_H */
@@ -7,13 +7,60 @@
  */
 
 #include "attestation.h"
+#include "sha256.h"
 #include <string.h>
-#include <stdio.h>
 
 /* Global attestation state */
 static attestation_report_t g_attestation_report;
 static bool g_attestation_initialized = false;
 
+/* Advanced on every report update; views compare against it */
+static volatile uint32_t g_report_generation = 0;
+
+#define EVENT_LOG_MASK  (MAX_EVENT_LOG_ENTRIES - 1)
+
+/* Interned event descriptions (stored by reference, ID = index) */
+static const char *g_event_strings[EVENT_STRING_TABLE_SIZE];
+static volatile uint32_t g_event_string_count = 0;
+
+/* Largest event chain record: tag, 4 words, description, payload */
+#define EVENT_CHAIN_RECORD_MAX  (1 + 16 + 1 + EVENT_STRING_MAX_LEN + 1 + EVENT_PAYLOAD_SIZE)
+
+/**
+ * @brief Store a 32-bit value little-endian
+ */
+static uint8_t *chain_put_u32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+/**
+ * @brief Extend a running digest: D = SHA-256(D || record)
+ */
+static void chain_extend(uint8_t *digest, const uint8_t *record, uint32_t len) {
+    sha256_context_t ctx;
+    
+    sha256_init(&ctx);
+    sha256_update(&ctx, digest, ATTESTATION_DIGEST_SIZE);
+    sha256_update(&ctx, record, len);
+    sha256_final(&ctx, digest);
+}
+
+/**
+ * @brief Extend a measurement chain with one measurement
+ */
+static void measurement_chain_extend(uint8_t *digest, const boot_measurement_t *m) {
+    uint8_t record[8 + 32];
+    uint8_t *p = chain_put_u32(record, m->component_id);
+    
+    p = chain_put_u32(p, m->measurement_type);
+    memcpy(p, m->measurement, 32);
+    chain_extend(digest, record, sizeof(record));
+}
+
 /**
  * @brief Initialize attestation system
  */
@@ -29,6 +76,8 @@ bool attestation_init(void) {
     g_attestation_report.boot_count = 0;
     g_attestation_report.measurement_count = 0;
     g_attestation_report.event_count = 0;
+    g_attestation_report.event_sequence = 0;
+    g_attestation_report.events_dropped = 0;
     
     g_attestation_initialized = true;
     
@@ -57,49 +106,266 @@ bool add_boot_measurement(uint32_t component_id, const uint8_t *measurement, uin
     memcpy(m->measurement, measurement, 32);
     m->measurement_type = type;
     
+    measurement_chain_extend(g_attestation_report.measurement_digest, m);
+    
     g_attestation_report.measurement_count++;
+    __atomic_add_fetch(&g_report_generation, 1, __ATOMIC_RELEASE);
     
     return true;
 }
 
 /**
- * @brief Add event to log
+ * @brief Intern an event description string
  */
-bool add_event_log_entry(uint32_t event_type, uint32_t event_data, const char *description) {
+uint8_t attestation_intern_string(const char *text) {
+    uint32_t count = g_event_string_count;
+    
+    if (text == NULL) {
+        return EVENT_STRING_NONE;
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        if (g_event_strings[i] == text ||
+            strncmp(g_event_strings[i], text, EVENT_STRING_MAX_LEN) == 0) {
+            return (uint8_t)i;
+        }
+    }
+    
+    if (count >= EVENT_STRING_TABLE_SIZE) {
+        return EVENT_STRING_NONE;  /* Table full */
+    }
+    
+    /* Store pointer before the ID becomes visible */
+    g_event_strings[count] = text;
+    __atomic_store_n(&g_event_string_count, count + 1, __ATOMIC_RELEASE);
+    
+    return (uint8_t)count;
+}
+
+/**
+ * @brief Look up an interned event description
+ */
+const char *attestation_event_string(uint8_t string_id) {
+    if (string_id >= __atomic_load_n(&g_event_string_count, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+    
+    return g_event_strings[string_id];
+}
+
+/**
+ * @brief Add event to log by interned string ID
+ * 
+ * The sequence number is claimed with an atomic increment (LDREX/STREX on
+ * Cortex-M33), so an ISR preempting a thread-context writer claims the
+ * next slot rather than sharing one. The slot is unpublished while it is
+ * rewritten and its sequence field is stored last.
+ */
+bool add_event_log_entry_id(uint32_t event_type, uint32_t event_data, uint8_t string_id,
+                            const uint8_t *payload, uint32_t payload_len) {
     if (!g_attestation_initialized) {
         return false;
     }
     
-    if (g_attestation_report.event_count >= MAX_EVENT_LOG_ENTRIES) {
-        return false;  /* Log full */
+    if (payload_len > EVENT_PAYLOAD_SIZE || (payload == NULL && payload_len != 0)) {
+        return false;
     }
     
-    event_log_entry_t *e = &g_attestation_report.events[g_attestation_report.event_count];
+    uint32_t seq = __atomic_add_fetch(&g_attestation_report.event_sequence, 1, __ATOMIC_RELAXED);
+    event_log_entry_t *e = &g_attestation_report.events[(seq - 1) & EVENT_LOG_MASK];
+    
+    __atomic_store_n(&e->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
     
     e->event_type = event_type;
     e->event_data = event_data;
     e->timestamp = 0;  /* In production: use hardware RTC */
+    e->string_id = string_id;
+    e->payload_len = (uint8_t)payload_len;
     
-    if (description != NULL) {
-        strncpy(e->description, description, sizeof(e->description) - 1);
-        e->description[sizeof(e->description) - 1] = '\0';
-    } else {
-        e->description[0] = '\0';
+    memset(e->payload, 0, sizeof(e->payload));
+    if (payload_len > 0) {
+        memcpy(e->payload, payload, payload_len);
     }
     
-    g_attestation_report.event_count++;
+    /* Publish entry */
+    __atomic_store_n(&e->sequence, seq, __ATOMIC_RELEASE);
+    
+    if (seq > MAX_EVENT_LOG_ENTRIES) {
+        __atomic_add_fetch(&g_attestation_report.events_dropped, 1, __ATOMIC_RELAXED);
+    } else {
+        __atomic_add_fetch(&g_attestation_report.event_count, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch(&g_report_generation, 1, __ATOMIC_RELEASE);
     
     return true;
 }
 
 /**
- * @brief Generate attestation report
+ * @brief Add event to log
  */
-bool generate_attestation_report(const uint8_t *nonce, attestation_report_t *report) {
-    if (!g_attestation_initialized || report == NULL) {
+bool add_event_log_entry(uint32_t event_type, uint32_t event_data, const char *description) {
+    /* A full string table still logs the event, without description */
+    uint8_t string_id = attestation_intern_string(description);
+    
+    return add_event_log_entry_id(event_type, event_data, string_id, NULL, 0);
+}
+
+/**
+ * @brief Get published ring entry for a sequence number
+ * @return Entry, or NULL if the slot is being rewritten
+ */
+static const event_log_entry_t *event_log_lookup(const attestation_report_t *report, uint32_t seq) {
+    const event_log_entry_t *e = &report->events[(seq - 1) & EVENT_LOG_MASK];
+    
+    return (e->sequence == seq) ? e : NULL;
+}
+
+/**
+ * @brief Get sequence number of the oldest entry held in the ring
+ */
+static uint32_t event_log_first(const attestation_report_t *report, uint32_t *count) {
+    uint32_t n = report->event_count;
+    
+    if (n > MAX_EVENT_LOG_ENTRIES) {
+        n = MAX_EVENT_LOG_ENTRIES;
+    }
+    
+    *count = n;
+    return report->event_sequence - n + 1;
+}
+
+/**
+ * @brief Get interned description for an entry (never NULL)
+ */
+static const char *event_log_description(const event_log_entry_t *e) {
+    const char *text = attestation_event_string(e->string_id);
+    
+    return (text != NULL) ? text : "";
+}
+
+/**
+ * @brief Copy a ring entry if it still holds a sequence number
+ * 
+ * Seqlock read: writers clear the sequence before rewriting a slot and
+ * store it last, so an unchanged sequence around the copy means the
+ * copy is consistent.
+ */
+static bool event_log_read(uint32_t seq, event_log_entry_t *out) {
+    const event_log_entry_t *e = &g_attestation_report.events[(seq - 1) & EVENT_LOG_MASK];
+    
+    if (__atomic_load_n(&e->sequence, __ATOMIC_ACQUIRE) != seq) {
         return false;
     }
     
+    memcpy(out, e, sizeof(*out));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    
+    return __atomic_load_n(&e->sequence, __ATOMIC_RELAXED) == seq;
+}
+
+/**
+ * @brief Fold a run of lost sequence numbers into the event chain
+ */
+static void event_chain_lost(uint32_t first_seq, uint32_t count) {
+    uint8_t record[9];
+    
+    record[0] = EVENT_CHAIN_TAG_LOST;
+    chain_put_u32(chain_put_u32(&record[1], first_seq), count);
+    chain_extend(g_attestation_report.event_digest, record, sizeof(record));
+}
+
+/**
+ * @brief Fold one entry into the event chain
+ */
+static void event_chain_entry(const event_log_entry_t *e) {
+    uint8_t record[EVENT_CHAIN_RECORD_MAX];
+    const char *text = event_log_description(e);
+    uint32_t text_len = 0;
+    uint8_t *p = record;
+    
+    while (text_len < EVENT_STRING_MAX_LEN && text[text_len] != '\0') {
+        text_len++;
+    }
+    
+    *p++ = EVENT_CHAIN_TAG_ENTRY;
+    p = chain_put_u32(p, e->sequence);
+    p = chain_put_u32(p, e->event_type);
+    p = chain_put_u32(p, e->event_data);
+    p = chain_put_u32(p, e->timestamp);
+    *p++ = (uint8_t)text_len;
+    memcpy(p, text, text_len);
+    p += text_len;
+    *p++ = e->payload_len;
+    memcpy(p, e->payload, e->payload_len);
+    p += e->payload_len;
+    
+    chain_extend(g_attestation_report.event_digest, record, (uint32_t)(p - record));
+}
+
+/**
+ * @brief Fold events logged since the last report into event_digest
+ * 
+ * Only entries newer than event_digest_sequence are hashed, so a
+ * challenge with no new events costs nothing here. Stops at an entry
+ * whose writer has not published it yet; it is folded next time.
+ */
+bool attestation_fold_events(void) {
+    if (!g_attestation_initialized) {
+        return false;
+    }
+    
+    uint32_t newest = __atomic_load_n(&g_attestation_report.event_sequence, __ATOMIC_ACQUIRE);
+    uint32_t seq = g_attestation_report.event_digest_sequence;
+    uint32_t lost_first = 0;
+    uint32_t lost = 0;
+    bool complete = true;
+    
+    /* Entries beyond the ring's reach are gone */
+    if (newest - seq > MAX_EVENT_LOG_ENTRIES) {
+        lost_first = seq + 1;
+        lost = newest - seq - MAX_EVENT_LOG_ENTRIES;
+        seq += lost;
+    }
+    
+    while (seq != newest) {
+        uint32_t next = seq + 1;
+        event_log_entry_t e;
+        
+        if (event_log_read(next, &e)) {
+            if (lost > 0) {
+                event_chain_lost(lost_first, lost);
+                lost = 0;
+            }
+            event_chain_entry(&e);
+        } else if (__atomic_load_n(&g_attestation_report.event_sequence, __ATOMIC_ACQUIRE) -
+                   next >= MAX_EVENT_LOG_ENTRIES) {
+            /* Slot already claimed by a newer event */
+            if (lost == 0) {
+                lost_first = next;
+            }
+            lost++;
+        } else {
+            complete = false;  /* Writer still filling the slot */
+            break;
+        }
+        
+        seq = next;
+    }
+    
+    if (lost > 0) {
+        event_chain_lost(lost_first, lost);
+    }
+    
+    g_attestation_report.event_digest_sequence = seq;
+    
+    return complete;
+}
+
+/**
+ * @brief Refresh report header fields for a new challenge
+ */
+static void attestation_refresh(const uint8_t *nonce) {
     /* Copy nonce for freshness proof */
     if (nonce != NULL) {
         memcpy(g_attestation_report.nonce, nonce, NONCE_SIZE);
@@ -111,145 +377,718 @@ bool generate_attestation_report(const uint8_t *nonce, attestation_report_t *rep
     /* In production: Read actual system uptime from RTC */
     g_attestation_report.uptime = 0;
     
-    /* Copy report to output */
-    memcpy(report, &g_attestation_report, sizeof(attestation_report_t));
+    attestation_fold_events();
     
-    return true;
+    __atomic_add_fetch(&g_report_generation, 1, __ATOMIC_RELEASE);
 }
 
 /**
- * @brief Sign attestation report
+ * @brief Compute the digest the report signature covers
  */
-bool sign_attestation_report(attestation_report_t *report) {
-    if (report == NULL) {
+bool attestation_claims_digest(const attestation_report_t *report, uint8_t *digest) {
+    attestation_claims_t claims;
+    
+    if (report == NULL || digest == NULL) {
         return false;
     }
     
+    claims.version = report->version;
+    memcpy(claims.nonce, report->nonce, NONCE_SIZE);
+    claims.boot_count = report->boot_count;
+    claims.firmware_version = report->firmware_version;
+    claims.security_status = report->security_status;
+    claims.tamper_events = report->tamper_events;
+    claims.uptime = report->uptime;
+    claims.measurement_count = report->measurement_count;
+    memcpy(claims.measurement_digest, report->measurement_digest, ATTESTATION_DIGEST_SIZE);
+    claims.event_digest_sequence = report->event_digest_sequence;
+    memcpy(claims.event_digest, report->event_digest, ATTESTATION_DIGEST_SIZE);
+    
+    sha256_compute((const uint8_t *)&claims, sizeof(claims), digest);
+    
+    return true;
+}
+
+/**
+ * @brief Fill placeholder signature
+ */
+static void attestation_write_signature(const attestation_report_t *report, uint8_t *signature) {
+    uint8_t digest[ATTESTATION_DIGEST_SIZE];
+    
+    /* Fixed-size claims: a couple of SHA-256 blocks however long the logs */
+    attestation_claims_digest(report, digest);
+    
     /* In production: Use Secure Vault for ECDSA signing
-     * 1. Compute SHA-256 hash of report (excluding signature field)
-     * 2. Sign hash with attestation private key (stored in PUF-wrapped form)
-     * 3. Store signature in report
+     * 1. Sign digest with attestation private key (stored in PUF-wrapped form)
+     * 2. Store signature in report
      */
     
-    /* For demonstration: Generate placeholder signature */
+    /* For demonstration: Generate placeholder signature bound to the digest */
     uint8_t placeholder_sig[ATTESTATION_SIGNATURE_SIZE] = {
         0xDE, 0xAD, 0xBE, 0xEF, 0xCA, 0xFE, 0xBA, 0xBE
     };
+    memcpy(&placeholder_sig[ATTESTATION_SIGNATURE_SIZE - ATTESTATION_DIGEST_SIZE],
+           digest, ATTESTATION_DIGEST_SIZE);
+    
+    memcpy(signature, placeholder_sig, ATTESTATION_SIGNATURE_SIZE);
+}
+
+/**
+ * @brief Generate attestation report
+ */
+bool generate_attestation_report(const uint8_t *nonce, attestation_report_t *report) {
+    if (!g_attestation_initialized) {
+        return false;
+    }
+    
+    attestation_refresh(nonce);
     
-    memcpy(report->signature, placeholder_sig, ATTESTATION_SIGNATURE_SIZE);
+    /* Copy report to output only if the caller wants its own copy */
+    if (report != NULL) {
+        memcpy(report, &g_attestation_report, sizeof(attestation_report_t));
+    }
     
     return true;
 }
 
 /**
- * @brief Export report to JSON format
+ * @brief Snapshot the live report for in-place reading
  */
-uint32_t export_report_json(const attestation_report_t *report, char *json_buffer, uint32_t buffer_size) {
-    if (report == NULL || json_buffer == NULL || buffer_size == 0) {
-        return 0;
+bool attestation_snapshot(const uint8_t *nonce, attestation_view_t *view) {
+    if (!g_attestation_initialized || view == NULL) {
+        return false;
     }
     
-    int written = 0;
-    char *buf = json_buffer;
-    uint32_t remaining = buffer_size;
+    attestation_refresh(nonce);
     
-    /* Start JSON object */
-    written = snprintf(buf, remaining, "{\n");
-    buf += written; remaining -= written;
+    view->report = &g_attestation_report;
+    view->generation = __atomic_load_n(&g_report_generation, __ATOMIC_ACQUIRE);
     
-    /* Version */
-    written = snprintf(buf, remaining, "  \"version\": %u,\n", report->version);
-    buf += written; remaining -= written;
+    return true;
+}
+
+/**
+ * @brief Check that a view still matches the live report
+ */
+bool attestation_view_valid(const attestation_view_t *view) {
+    if (view == NULL || view->report != &g_attestation_report) {
+        return false;
+    }
     
-    /* Boot count */
-    written = snprintf(buf, remaining, "  \"boot_count\": %u,\n", report->boot_count);
-    buf += written; remaining -= written;
+    return view->generation == __atomic_load_n(&g_report_generation, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Sign attestation report
+ */
+bool sign_attestation_report(attestation_report_t *report) {
+    if (report == NULL) {
+        return false;
+    }
     
-    /* Firmware version */
-    written = snprintf(buf, remaining, "  \"firmware_version\": \"0x%08X\",\n", report->firmware_version);
-    buf += written; remaining -= written;
+    attestation_write_signature(report, report->signature);
     
-    /* Security status */
-    written = snprintf(buf, remaining, "  \"security_status\": \"0x%08X\",\n", report->security_status);
-    buf += written; remaining -= written;
+    return true;
+}
+
+/**
+ * @brief Sign the live report in place through a view
+ */
+bool sign_attestation_view(const attestation_view_t *view) {
+    if (!attestation_view_valid(view)) {
+        return false;
+    }
     
-    /* Tamper events */
-    written = snprintf(buf, remaining, "  \"tamper_events\": %u,\n", report->tamper_events);
-    buf += written; remaining -= written;
+    /* Signature field is excluded from the signed content, so writing
+     * it does not advance the generation */
+    attestation_write_signature(&g_attestation_report, g_attestation_report.signature);
     
-    /* Uptime */
-    written = snprintf(buf, remaining, "  \"uptime\": %llu,\n", (unsigned long long)report->uptime);
-    buf += written; remaining -= written;
+    return attestation_view_valid(view);
+}
+
+/* Streaming writer: stages output and hands it to the sink in fixed-size
+ * fragments. With a NULL sink it only counts bytes. */
+typedef struct {
+    attestation_sink_t sink;
+    void *sink_ctx;
+    uint8_t stage[ATTESTATION_SINK_CHUNK_SIZE];
+    uint32_t stage_len;
+    uint32_t total;
+    bool error;
+} report_writer_t;
+
+/* Fixed buffer sink context */
+typedef struct {
+    uint8_t *buffer;
+    uint32_t size;
+    uint32_t used;
+    bool truncated;
+} buffer_sink_t;
+
+/**
+ * @brief Initialize streaming writer
+ */
+static void writer_init(report_writer_t *w, attestation_sink_t sink, void *sink_ctx) {
+    w->sink = sink;
+    w->sink_ctx = sink_ctx;
+    w->stage_len = 0;
+    w->total = 0;
+    w->error = false;
+}
+
+/**
+ * @brief Hand staged bytes to the sink
+ */
+static void writer_flush(report_writer_t *w) {
+    if (w->stage_len > 0 && !w->error) {
+        if (!w->sink(w->sink_ctx, w->stage, w->stage_len)) {
+            w->error = true;
+        }
+    }
+    w->stage_len = 0;
+}
+
+/**
+ * @brief Append bytes to the writer
+ */
+static void writer_put(report_writer_t *w, const uint8_t *data, uint32_t len) {
+    w->total += len;
     
-    /* Measurements */
-    written = snprintf(buf, remaining, "  \"measurements\": [\n");
-    buf += written; remaining -= written;
+    if (w->sink == NULL || w->error) {
+        return;
+    }
     
-    for (uint32_t i = 0; i < report->measurement_count; i++) {
-        const boot_measurement_t *m = &report->measurements[i];
-        written = snprintf(buf, remaining, "    {\n      \"component_id\": %u,\n", m->component_id);
-        buf += written; remaining -= written;
+    while (len > 0) {
+        uint32_t space = ATTESTATION_SINK_CHUNK_SIZE - w->stage_len;
+        uint32_t n = (len < space) ? len : space;
         
-        written = snprintf(buf, remaining, "      \"measurement\": \"");
-        buf += written; remaining -= written;
+        memcpy(&w->stage[w->stage_len], data, n);
+        w->stage_len += n;
+        data += n;
+        len -= n;
         
-        for (int j = 0; j < 32; j++) {
-            written = snprintf(buf, remaining, "%02X", m->measurement[j]);
-            buf += written; remaining -= written;
+        if (w->stage_len == ATTESTATION_SINK_CHUNK_SIZE) {
+            writer_flush(w);
         }
+    }
+}
+
+/**
+ * @brief Finish writer and return byte count (0 on error)
+ */
+static uint32_t writer_finish(report_writer_t *w) {
+    if (w->sink != NULL) {
+        writer_flush(w);
+    }
+    
+    return w->error ? 0 : w->total;
+}
+
+/**
+ * @brief Sink writing into a fixed caller buffer
+ * 
+ * Copies as much as fits and reports truncation by returning false.
+ */
+static bool buffer_sink(void *sink_ctx, const uint8_t *data, uint32_t len) {
+    buffer_sink_t *b = (buffer_sink_t *)sink_ctx;
+    uint32_t space = b->size - b->used;
+    
+    if (len > space) {
+        memcpy(&b->buffer[b->used], data, space);
+        b->used += space;
+        b->truncated = true;
+        return false;  /* Buffer too small */
+    }
+    
+    memcpy(&b->buffer[b->used], data, len);
+    b->used += len;
+    
+    return true;
+}
+
+/* Hex digit lookup table */
+static const char k_hex_digits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+/* Emit a string literal without strlen */
+#define JSON_LIT(w, lit)    writer_put((w), (const uint8_t *)(lit), sizeof(lit) - 1)
+
+/**
+ * @brief Emit unsigned decimal integer
+ */
+static void json_uint(report_writer_t *w, uint64_t value) {
+    uint8_t digits[20];
+    uint32_t pos = sizeof(digits);
+    
+    do {
+        digits[--pos] = (uint8_t)('0' + (value % 10));
+        value /= 10;
+    } while (value != 0);
+    
+    writer_put(w, &digits[pos], sizeof(digits) - pos);
+}
+
+/**
+ * @brief Emit uppercase hex string of a byte array
+ */
+static void json_hex(report_writer_t *w, const uint8_t *data, uint32_t len) {
+    uint8_t out[32];
+    
+    while (len > 0) {
+        uint32_t n = (len > sizeof(out) / 2) ? (uint32_t)(sizeof(out) / 2) : len;
         
-        written = snprintf(buf, remaining, "\",\n      \"type\": %u\n    }", 
-                          m->measurement_type);
-        buf += written; remaining -= written;
+        for (uint32_t i = 0; i < n; i++) {
+            out[i * 2] = (uint8_t)k_hex_digits[data[i] >> 4];
+            out[i * 2 + 1] = (uint8_t)k_hex_digits[data[i] & 0x0F];
+        }
+        
+        writer_put(w, out, n * 2);
+        data += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief Emit 32-bit value as quoted "0xXXXXXXXX"
+ */
+static void json_hex32(report_writer_t *w, uint32_t value) {
+    uint8_t out[12] = { '"', '0', 'x' };
+    
+    for (int i = 0; i < 8; i++) {
+        out[3 + i] = (uint8_t)k_hex_digits[(value >> (28 - i * 4)) & 0x0F];
+    }
+    out[11] = '"';
+    
+    writer_put(w, out, sizeof(out));
+}
+
+/**
+ * @brief Emit bounded C string with JSON escaping
+ */
+static void json_string(report_writer_t *w, const char *text, uint32_t max_len) {
+    for (uint32_t i = 0; i < max_len && text[i] != '\0'; i++) {
+        uint8_t c = (uint8_t)text[i];
         
-        if (i < report->measurement_count - 1) {
-            written = snprintf(buf, remaining, ",\n");
+        if (c == '"' || c == '\\') {
+            uint8_t esc[2] = { '\\', c };
+            writer_put(w, esc, sizeof(esc));
+        } else if (c < 0x20) {
+            uint8_t esc[6] = { '\\', 'u', '0', '0', (uint8_t)k_hex_digits[c >> 4], (uint8_t)k_hex_digits[c & 0x0F] };
+            writer_put(w, esc, sizeof(esc));
         } else {
-            written = snprintf(buf, remaining, "\n");
+            writer_put(w, &c, 1);
         }
-        buf += written; remaining -= written;
     }
+}
+
+/**
+ * @brief Encode full report as JSON
+ */
+static uint32_t json_encode_report(const attestation_report_t *report, report_writer_t *w) {
+    uint32_t measurement_count = report->measurement_count;
+    uint32_t event_count;
+    uint32_t first_seq = event_log_first(report, &event_count);
+    bool first_event = true;
+    
+    if (measurement_count > MAX_MEASUREMENT_COUNT) {
+        measurement_count = MAX_MEASUREMENT_COUNT;
+    }
+    
+    JSON_LIT(w, "{\n  \"version\": ");
+    json_uint(w, report->version);
+    
+    JSON_LIT(w, ",\n  \"nonce\": \"");
+    json_hex(w, report->nonce, NONCE_SIZE);
+    
+    JSON_LIT(w, "\",\n  \"boot_count\": ");
+    json_uint(w, report->boot_count);
+    
+    JSON_LIT(w, ",\n  \"firmware_version\": ");
+    json_hex32(w, report->firmware_version);
     
-    written = snprintf(buf, remaining, "  ],\n");
-    buf += written; remaining -= written;
+    JSON_LIT(w, ",\n  \"security_status\": ");
+    json_hex32(w, report->security_status);
     
-    /* Events */
-    written = snprintf(buf, remaining, "  \"events\": [\n");
-    buf += written; remaining -= written;
+    JSON_LIT(w, ",\n  \"tamper_events\": ");
+    json_uint(w, report->tamper_events);
     
-    for (uint32_t i = 0; i < report->event_count; i++) {
-        const event_log_entry_t *e = &report->events[i];
-        written = snprintf(buf, remaining, 
-                          "    {\n      \"type\": %u,\n      \"data\": %u,\n"
-                          "      \"timestamp\": %llu,\n      \"description\": \"%s\"\n    }",
-                          e->event_type, e->event_data, 
-                          (unsigned long long)e->timestamp, e->description);
-        buf += written; remaining -= written;
+    JSON_LIT(w, ",\n  \"uptime\": ");
+    json_uint(w, report->uptime);
+    
+    /* Measurements */
+    JSON_LIT(w, ",\n  \"measurements\": [\n");
+    
+    for (uint32_t i = 0; i < measurement_count; i++) {
+        const boot_measurement_t *m = &report->measurements[i];
+        
+        JSON_LIT(w, "    {\n      \"component_id\": ");
+        json_uint(w, m->component_id);
+        JSON_LIT(w, ",\n      \"measurement\": \"");
+        json_hex(w, m->measurement, sizeof(m->measurement));
+        JSON_LIT(w, "\",\n      \"type\": ");
+        json_uint(w, m->measurement_type);
+        JSON_LIT(w, "\n    }");
         
-        if (i < report->event_count - 1) {
-            written = snprintf(buf, remaining, ",\n");
+        if (i < measurement_count - 1) {
+            JSON_LIT(w, ",\n");
         } else {
-            written = snprintf(buf, remaining, "\n");
+            JSON_LIT(w, "\n");
+        }
+    }
+    
+    JSON_LIT(w, "  ],\n  \"measurement_digest\": \"");
+    json_hex(w, report->measurement_digest, ATTESTATION_DIGEST_SIZE);
+    
+    /* Events, oldest first */
+    JSON_LIT(w, "\",\n  \"events_dropped\": ");
+    json_uint(w, report->events_dropped);
+    JSON_LIT(w, ",\n  \"events\": [\n");
+    
+    for (uint32_t i = 0; i < event_count; i++) {
+        const event_log_entry_t *e = event_log_lookup(report, first_seq + i);
+        
+        if (e == NULL) {
+            continue;
+        }
+        
+        if (!first_event) {
+            JSON_LIT(w, ",\n");
         }
-        buf += written; remaining -= written;
+        first_event = false;
+        
+        JSON_LIT(w, "    {\n      \"sequence\": ");
+        json_uint(w, e->sequence);
+        JSON_LIT(w, ",\n      \"type\": ");
+        json_uint(w, e->event_type);
+        JSON_LIT(w, ",\n      \"data\": ");
+        json_uint(w, e->event_data);
+        JSON_LIT(w, ",\n      \"timestamp\": ");
+        json_uint(w, e->timestamp);
+        JSON_LIT(w, ",\n      \"description\": \"");
+        json_string(w, event_log_description(e), EVENT_STRING_MAX_LEN);
+        JSON_LIT(w, "\",\n      \"payload\": \"");
+        json_hex(w, e->payload, e->payload_len);
+        JSON_LIT(w, "\"\n    }");
+    }
+    
+    if (!first_event) {
+        JSON_LIT(w, "\n");
     }
     
-    written = snprintf(buf, remaining, "  ],\n");
-    buf += written; remaining -= written;
+    JSON_LIT(w, "  ],\n  \"event_digest_sequence\": ");
+    json_uint(w, report->event_digest_sequence);
+    JSON_LIT(w, ",\n  \"event_digest\": \"");
+    json_hex(w, report->event_digest, ATTESTATION_DIGEST_SIZE);
     
     /* Signature */
-    written = snprintf(buf, remaining, "  \"signature\": \"");
-    buf += written; remaining -= written;
+    JSON_LIT(w, "\",\n  \"signature\": \"");
+    json_hex(w, report->signature, ATTESTATION_SIGNATURE_SIZE);
+    JSON_LIT(w, "\"\n}\n");
+    
+    return writer_finish(w);
+}
+
+/**
+ * @brief Stream report as JSON into a sink
+ */
+uint32_t export_report_json_stream(const attestation_report_t *report,
+                                   attestation_sink_t sink, void *sink_ctx) {
+    report_writer_t w;
+    
+    if (report == NULL || sink == NULL) {
+        return 0;
+    }
+    
+    writer_init(&w, sink, sink_ctx);
+    
+    return json_encode_report(report, &w);
+}
+
+/**
+ * @brief Export report to JSON format
+ */
+uint32_t export_report_json(const attestation_report_t *report, char *json_buffer, uint32_t buffer_size) {
+    if (report == NULL || json_buffer == NULL || buffer_size == 0) {
+        return 0;
+    }
+    
+    /* Reserve one byte for the terminator */
+    buffer_sink_t b = {
+        .buffer = (uint8_t *)json_buffer,
+        .size = buffer_size - 1,
+        .used = 0,
+        .truncated = false
+    };
+    
+    uint32_t written = export_report_json_stream(report, buffer_sink, &b);
+    
+    json_buffer[b.used] = '\0';
+    
+    return b.truncated ? 0 : written;
+}
+
+/* CBOR major types */
+#define CBOR_MAJOR_UINT     0
+#define CBOR_MAJOR_BYTES    2
+#define CBOR_MAJOR_TEXT     3
+#define CBOR_MAJOR_ARRAY    4
+#define CBOR_MAJOR_MAP      5
+
+/**
+ * @brief Emit CBOR head with shortest-form argument
+ */
+static void cbor_head(report_writer_t *w, uint8_t major, uint64_t value) {
+    uint8_t head[9];
+    uint32_t len;
+    uint8_t type = (uint8_t)(major << 5);
+    
+    if (value < 24) {
+        head[0] = type | (uint8_t)value;
+        len = 1;
+    } else if (value <= 0xFF) {
+        head[0] = type | 24;
+        head[1] = (uint8_t)value;
+        len = 2;
+    } else if (value <= 0xFFFF) {
+        head[0] = type | 25;
+        head[1] = (uint8_t)(value >> 8);
+        head[2] = (uint8_t)value;
+        len = 3;
+    } else if (value <= 0xFFFFFFFF) {
+        head[0] = type | 26;
+        for (int i = 0; i < 4; i++) {
+            head[1 + i] = (uint8_t)(value >> (24 - i * 8));
+        }
+        len = 5;
+    } else {
+        head[0] = type | 27;
+        for (int i = 0; i < 8; i++) {
+            head[1 + i] = (uint8_t)(value >> (56 - i * 8));
+        }
+        len = 9;
+    }
+    
+    writer_put(w, head, len);
+}
+
+/**
+ * @brief Emit CBOR byte string
+ */
+static void cbor_bytes(report_writer_t *w, const uint8_t *data, uint32_t len) {
+    cbor_head(w, CBOR_MAJOR_BYTES, len);
+    writer_put(w, data, len);
+}
+
+/**
+ * @brief Emit CBOR text string from a bounded C string
+ */
+static void cbor_text(report_writer_t *w, const char *text, uint32_t max_len) {
+    uint32_t len = 0;
+    
+    while (len < max_len && text[len] != '\0') {
+        len++;
+    }
+    
+    cbor_head(w, CBOR_MAJOR_TEXT, len);
+    writer_put(w, (const uint8_t *)text, len);
+}
+
+/* Portion of the logs a CBOR report carries */
+typedef struct {
+    bool delta;                  /* Emit the delta base keys */
+    uint32_t first_measurement;  /* Index of first measurement sent */
+    uint32_t event_base;         /* Delta: sequence the events follow */
+    uint32_t first_seq;          /* First event sequence sent */
+    uint32_t event_count;        /* Sequences from first_seq to scan */
+} cbor_range_t;
+
+/**
+ * @brief Range covering the whole report
+ */
+static void cbor_range_full(const attestation_report_t *report, cbor_range_t *range) {
+    range->delta = false;
+    range->first_measurement = 0;
+    range->event_base = 0;
+    range->first_seq = event_log_first(report, &range->event_count);
+}
+
+/**
+ * @brief Range covering what the verifier has not acknowledged
+ * 
+ * Replays the measurement chain to find the acknowledged prefix (at most
+ * MAX_MEASUREMENT_COUNT small hashes), and sends events up to the folded
+ * sequence so the verifier can extend its chain to event_digest.
+ */
+static void cbor_range_delta(const attestation_report_t *report, const attestation_ack_t *ack,
+                             cbor_range_t *range) {
+    uint32_t measurement_count = report->measurement_count;
+    uint8_t digest[ATTESTATION_DIGEST_SIZE];
+    uint32_t held;
+    uint32_t oldest = event_log_first(report, &held);
+    uint32_t last = report->event_digest_sequence;
+    
+    if (measurement_count > MAX_MEASUREMENT_COUNT) {
+        measurement_count = MAX_MEASUREMENT_COUNT;
+    }
+    
+    range->delta = true;
+    range->first_measurement = 0;
+    memset(digest, 0, sizeof(digest));
+    for (uint32_t i = 0; i <= measurement_count; i++) {
+        if (memcmp(digest, ack->measurement_digest, sizeof(digest)) == 0) {
+            range->first_measurement = i;
+        }
+        if (i < measurement_count) {
+            measurement_chain_extend(digest, &report->measurements[i]);
+        }
+    }
+    
+    /* An acknowledgement ahead of the device predates a reset */
+    range->event_base = (ack->event_sequence <= last) ? ack->event_sequence : 0;
+    range->first_seq = range->event_base + 1;
+    if (held == 0 || range->first_seq < oldest) {
+        range->first_seq = oldest;
+    }
+    range->event_count = (last >= range->first_seq) ? last - range->first_seq + 1 : 0;
+}
+
+/**
+ * @brief Encode a report range as a CBOR map in a single pass
+ */
+static uint32_t cbor_encode_report(const attestation_report_t *report, const cbor_range_t *range,
+                                   report_writer_t *w) {
+    uint32_t measurement_count = report->measurement_count;
+    uint32_t event_count = range->event_count;
+    uint32_t first_seq = range->first_seq;
+    uint32_t first_measurement = range->first_measurement;
+    uint32_t published = 0;
+    
+    if (measurement_count > MAX_MEASUREMENT_COUNT) {
+        measurement_count = MAX_MEASUREMENT_COUNT;
+    }
+    if (first_measurement > measurement_count) {
+        first_measurement = measurement_count;
+    }
+    
+    /* Array header needs the count of published entries up front */
+    for (uint32_t i = 0; i < event_count; i++) {
+        if (event_log_lookup(report, first_seq + i) != NULL) {
+            published++;
+        }
+    }
+    
+    cbor_head(w, CBOR_MAJOR_MAP, range->delta ? CBOR_DELTA_MAP_ENTRIES : CBOR_REPORT_MAP_ENTRIES);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_VERSION);
+    cbor_head(w, CBOR_MAJOR_UINT, report->version);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_BOOT_COUNT);
+    cbor_head(w, CBOR_MAJOR_UINT, report->boot_count);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_FIRMWARE_VERSION);
+    cbor_head(w, CBOR_MAJOR_UINT, report->firmware_version);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_NONCE);
+    cbor_bytes(w, report->nonce, NONCE_SIZE);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_SECURITY_STATUS);
+    cbor_head(w, CBOR_MAJOR_UINT, report->security_status);
     
-    for (int i = 0; i < ATTESTATION_SIGNATURE_SIZE; i++) {
-        written = snprintf(buf, remaining, "%02X", report->signature[i]);
-        buf += written; remaining -= written;
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_TAMPER_EVENTS);
+    cbor_head(w, CBOR_MAJOR_UINT, report->tamper_events);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_UPTIME);
+    cbor_head(w, CBOR_MAJOR_UINT, report->uptime);
+    
+    /* Measurements as compact arrays */
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_MEASUREMENTS);
+    cbor_head(w, CBOR_MAJOR_ARRAY, measurement_count - first_measurement);
+    for (uint32_t i = first_measurement; i < measurement_count; i++) {
+        const boot_measurement_t *m = &report->measurements[i];
+        cbor_head(w, CBOR_MAJOR_ARRAY, 3);
+        cbor_head(w, CBOR_MAJOR_UINT, m->component_id);
+        cbor_bytes(w, m->measurement, sizeof(m->measurement));
+        cbor_head(w, CBOR_MAJOR_UINT, m->measurement_type);
+    }
+    
+    /* Events as compact arrays, oldest first */
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_EVENTS);
+    cbor_head(w, CBOR_MAJOR_ARRAY, published);
+    for (uint32_t i = 0; i < event_count; i++) {
+        const event_log_entry_t *e = event_log_lookup(report, first_seq + i);
+        if (e == NULL) {
+            continue;
+        }
+        cbor_head(w, CBOR_MAJOR_ARRAY, 6);
+        cbor_head(w, CBOR_MAJOR_UINT, e->sequence);
+        cbor_head(w, CBOR_MAJOR_UINT, e->event_type);
+        cbor_head(w, CBOR_MAJOR_UINT, e->event_data);
+        cbor_head(w, CBOR_MAJOR_UINT, e->timestamp);
+        cbor_text(w, event_log_description(e), EVENT_STRING_MAX_LEN);
+        cbor_bytes(w, e->payload, e->payload_len);
+    }
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_SIGNATURE);
+    cbor_bytes(w, report->signature, ATTESTATION_SIGNATURE_SIZE);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_EVENTS_DROPPED);
+    cbor_head(w, CBOR_MAJOR_UINT, report->events_dropped);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_MEASUREMENT_DIGEST);
+    cbor_bytes(w, report->measurement_digest, ATTESTATION_DIGEST_SIZE);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_EVENT_DIGEST);
+    cbor_bytes(w, report->event_digest, ATTESTATION_DIGEST_SIZE);
+    
+    cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_EVENT_DIGEST_SEQ);
+    cbor_head(w, CBOR_MAJOR_UINT, report->event_digest_sequence);
+    
+    if (range->delta) {
+        cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_MEASUREMENT_BASE);
+        cbor_head(w, CBOR_MAJOR_UINT, first_measurement);
+        
+        cbor_head(w, CBOR_MAJOR_UINT, CBOR_KEY_EVENT_BASE);
+        cbor_head(w, CBOR_MAJOR_UINT, range->event_base);
+    }
+    
+    return writer_finish(w);
+}
+
+/**
+ * @brief Compute exact CBOR encoded size of a report
+ */
+uint32_t cbor_encoded_size(const attestation_report_t *report) {
+    report_writer_t w;
+    cbor_range_t range;
+    
+    if (report == NULL) {
+        return 0;
+    }
+    
+    cbor_range_full(report, &range);
+    writer_init(&w, NULL, NULL);
+    
+    return cbor_encode_report(report, &range, &w);
+}
+
+/**
+ * @brief Stream report as CBOR into a sink
+ */
+uint32_t export_report_cbor_stream(const attestation_report_t *report,
+                                   attestation_sink_t sink, void *sink_ctx) {
+    report_writer_t w;
+    cbor_range_t range;
+    
+    if (report == NULL || sink == NULL) {
+        return 0;
     }
     
-    written = snprintf(buf, remaining, "\"\n}\n");
-    buf += written; remaining -= written;
+    cbor_range_full(report, &range);
+    writer_init(&w, sink, sink_ctx);
     
-    return (buffer_size - remaining);
+    return cbor_encode_report(report, &range, &w);
 }
 
 /**
@@ -260,38 +1099,50 @@ uint32_t export_report_cbor(const attestation_report_t *report, uint8_t *cbor_bu
         return 0;
     }
     
-    /* Simplified CBOR encoding for demonstration
-     * In production: Use a full CBOR library like QCBOR or tinycbor
-     */
-    
-    uint32_t offset = 0;
+    buffer_sink_t b = {
+        .buffer = cbor_buffer,
+        .size = buffer_size,
+        .used = 0,
+        .truncated = false
+    };
     
-    /* CBOR map header (major type 5) */
-    cbor_buffer[offset++] = 0xA8;  /* Map with 8 entries */
+    return export_report_cbor_stream(report, buffer_sink, &b);
+}
+
+/**
+ * @brief Stream a delta report as CBOR into a sink
+ */
+uint32_t export_report_cbor_delta_stream(const attestation_report_t *report,
+                                         const attestation_ack_t *ack,
+                                         attestation_sink_t sink, void *sink_ctx) {
+    report_writer_t w;
+    cbor_range_t range;
     
-    /* Version */
-    cbor_buffer[offset++] = 0x01;  /* Key: 1 */
-    cbor_buffer[offset++] = 0x18;  /* Unsigned int (1 byte) */
-    cbor_buffer[offset++] = report->version;
+    if (report == NULL || ack == NULL || sink == NULL) {
+        return 0;
+    }
     
-    /* Boot count */
-    cbor_buffer[offset++] = 0x02;  /* Key: 2 */
-    cbor_buffer[offset++] = 0x1A;  /* Unsigned int (4 bytes) */
-    cbor_buffer[offset++] = (report->boot_count >> 24) & 0xFF;
-    cbor_buffer[offset++] = (report->boot_count >> 16) & 0xFF;
-    cbor_buffer[offset++] = (report->boot_count >> 8) & 0xFF;
-    cbor_buffer[offset++] = report->boot_count & 0xFF;
+    cbor_range_delta(report, ack, &range);
+    writer_init(&w, sink, sink_ctx);
     
-    /* Firmware version */
-    cbor_buffer[offset++] = 0x03;  /* Key: 3 */
-    cbor_buffer[offset++] = 0x1A;  /* Unsigned int (4 bytes) */
-    cbor_buffer[offset++] = (report->firmware_version >> 24) & 0xFF;
-    cbor_buffer[offset++] = (report->firmware_version >> 16) & 0xFF;
-    cbor_buffer[offset++] = (report->firmware_version >> 8) & 0xFF;
-    cbor_buffer[offset++] = report->firmware_version & 0xFF;
+    return cbor_encode_report(report, &range, &w);
+}
+
+/**
+ * @brief Export only what a verifier has not seen, as CBOR
+ */
+uint32_t export_report_cbor_delta(const attestation_report_t *report, const attestation_ack_t *ack,
+                                  uint8_t *cbor_buffer, uint32_t buffer_size) {
+    if (report == NULL || ack == NULL || cbor_buffer == NULL || buffer_size == 0) {
+        return 0;
+    }
     
-    /* Add more fields as needed... */
-    /* This is a simplified demonstration */
+    buffer_sink_t b = {
+        .buffer = cbor_buffer,
+        .size = buffer_size,
+        .used = 0,
+        .truncated = false
+    };
     
-    return offset;
+    return export_report_cbor_delta_stream(report, ack, buffer_sink, &b);
 }
@@ -3,38 +3,183 @@
  * @brief Anti-Rollback Protection Implementation
  * 
  * Implements OTP counter management and version verification to prevent
- * firmware downgrade attacks.
+ * firmware downgrade attacks. Counters are thermometer coded across
+ * OTP_COUNTER_WORDS words and decoded with popcount; the security epoch
+ * counter is only advanced by releases that must not be rolled back.
  */
 
 #include "anti_rollback.h"
+#include "secure_boot.h"
 #include <string.h>
+#if defined(SIM_PERIPH_MOCK)
+#include "mock_periph.h"
+#endif
 
-/* Simulated OTP storage (in production, use actual EFR32 OTP) */
-static uint32_t g_otp_counters[MAX_OTP_COUNTERS];
+/* OTP block word indices (version word followed by the counters) */
+#define OTP_SHADOW_VERSION_WORD     0
+#define OTP_SHADOW_COUNTER_WORD     1
+#define OTP_SHADOW_WORDS            ANTI_ROLLBACK_SHADOW_WORDS
+
+/* Simulated OTP storage (in production, use actual EFR32 OTP).
+ * Counters are thermometer coded: value = number of programmed bits. */
+#if defined(SIM_PERIPH_MOCK)
+#define g_otp_counters  (g_mock_periph.otp_counters)
+#define g_otp_version   (g_mock_periph.otp_version)
+#else
+static uint32_t g_otp_counters[MAX_OTP_COUNTERS][OTP_COUNTER_WORDS];
 static version_t g_otp_version;
+#endif
 static bool g_anti_rollback_initialized = false;
 
+/* RAM shadow of the OTP block, read once at init. The complement mirror
+ * serves redundant checks and the CRC catches corruption of either copy. */
+static uint32_t g_otp_shadow[OTP_SHADOW_WORDS];
+static uint32_t g_otp_shadow_mirror[OTP_SHADOW_WORDS];
+static uint32_t g_otp_shadow_crc;
+
 /**
- * @brief Initialize anti-rollback system
+ * @brief Pack a version into its OTP word layout
  */
-bool anti_rollback_init(void) {
-    if (g_anti_rollback_initialized) {
-        return true;
+static uint32_t version_to_word(const version_t *version) {
+    return ((uint32_t)version->major << 24) |
+           ((uint32_t)version->minor << 16) |
+           version->patch;
+}
+
+/**
+ * @brief Unpack an OTP version word
+ */
+static void word_to_version(uint32_t word, version_t *version) {
+    version->major = (word >> 24) & 0xFF;
+    version->minor = (word >> 16) & 0xFF;
+    version->patch = word & 0xFFFF;
+}
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected) over shadow words
+ */
+static uint32_t otp_shadow_crc32(const uint32_t *words, uint32_t count) {
+    uint32_t crc = 0xFFFFFFFF;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        crc ^= words[i];
+        for (int bit = 0; bit < 32; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0U - (crc & 1U)));
+        }
+    }
+    
+    return ~crc;
+}
+
+/**
+ * @brief Update one shadow word, its mirror, and the CRC
+ */
+static void otp_shadow_store(uint32_t index, uint32_t word) {
+    g_otp_shadow[index] = word;
+    g_otp_shadow_mirror[index] = ~word;
+    g_otp_shadow_crc = otp_shadow_crc32(g_otp_shadow, OTP_SHADOW_WORDS);
+}
+
+/**
+ * @brief Check shadow against its CRC and complement mirror
+ */
+static bool otp_shadow_valid(void) {
+    uint32_t diff = 0;
+    
+    for (uint32_t i = 0; i < OTP_SHADOW_WORDS; i++) {
+        diff |= g_otp_shadow[i] ^ ~g_otp_shadow_mirror[i];
     }
     
-    /* In production: Read OTP counters and version from hardware
-     * Reference: EFR32 OTP Memory Map
+    return diff == 0 &&
+           otp_shadow_crc32(g_otp_shadow, OTP_SHADOW_WORDS) == g_otp_shadow_crc;
+}
+
+/**
+ * @brief Program bits in one OTP counter word (0->1 only)
+ */
+static void otp_program_counter_word(uint32_t counter_index, uint32_t word_index, uint32_t bits) {
+    /* In production: single MSC word write; unprogrammed bits stay 0
+     * write_otp_word(OTP_COUNTER_BASE_ADDRESS +
+     *                (counter_index * OTP_COUNTER_WORDS + word_index) * 4, bits);
      */
     
-    /* Initialize simulated OTP storage */
-    for (int i = 0; i < MAX_OTP_COUNTERS; i++) {
-        g_otp_counters[i] = 0;
+    g_otp_counters[counter_index][word_index] |= bits;
+}
+
+/**
+ * @brief Decode a thermometer-coded counter
+ */
+static uint32_t otp_counter_decode(const uint32_t *words) {
+    uint32_t value = 0;
+    
+    /* Programmed bits only ever accumulate, so popcount stays monotonic
+     * even if a write was torn or a stray bit was set */
+    for (uint32_t w = 0; w < OTP_COUNTER_WORDS; w++) {
+        value += (uint32_t)__builtin_popcount(words[w]);
     }
     
-    /* Read current version from OTP */
+    return value;
+}
+
+/**
+ * @brief Read the whole OTP counter/version block into the shadow
+ */
+static void otp_shadow_load(void) {
+    /* In production: one pass over the OTP block
+     * const volatile uint32_t *otp = (const volatile uint32_t *)OTP_COUNTER_BASE_ADDRESS;
+     * g_otp_shadow[OTP_SHADOW_VERSION_WORD] = otp[OTP_VERSION_COUNTER_OFFSET / 4];
+     * counters are the MAX_OTP_COUNTERS * OTP_COUNTER_WORDS words at otp[0]
+     */
+    
+    g_otp_shadow[OTP_SHADOW_VERSION_WORD] = version_to_word(&g_otp_version);
+    
+    /* All counters decoded in one pass over the contiguous block */
+    for (uint32_t i = 0; i < MAX_OTP_COUNTERS; i++) {
+        g_otp_shadow[OTP_SHADOW_COUNTER_WORD + i] = otp_counter_decode(g_otp_counters[i]);
+    }
+    
+    for (uint32_t i = 0; i < OTP_SHADOW_WORDS; i++) {
+        g_otp_shadow_mirror[i] = ~g_otp_shadow[i];
+    }
+    g_otp_shadow_crc = otp_shadow_crc32(g_otp_shadow, OTP_SHADOW_WORDS);
+}
+
+/**
+ * @brief Order two packed version words
+ */
+static rollback_status_t compare_version_words(uint32_t new_word, uint32_t current_word) {
+    /* major:minor:patch packs most-significant first, so word order
+     * is version order */
+    if (new_word > current_word) {
+        return ROLLBACK_VERSION_HIGHER;
+    }
+    
+    if (new_word < current_word) {
+        return ROLLBACK_CHECK_FAIL;  /* Downgrade detected */
+    }
+    
+    return ROLLBACK_VERSION_EQUAL;
+}
+
+/**
+ * @brief Initialize anti-rollback system
+ */
+bool anti_rollback_init(void) {
+    if (g_anti_rollback_initialized) {
+        return true;
+    }
+
+#if !defined(SIM_PERIPH_MOCK)
+    /* Initialize simulated OTP storage (the mock layer provisions its own) */
+    memset(g_otp_counters, 0, sizeof(g_otp_counters));
+    
     g_otp_version.major = FIRMWARE_VERSION_MAJOR;
     g_otp_version.minor = FIRMWARE_VERSION_MINOR;
     g_otp_version.patch = FIRMWARE_VERSION_PATCH;
+#endif
+    
+    /* Single OTP read; all later checks are served from the shadow */
+    otp_shadow_load();
     
     g_anti_rollback_initialized = true;
     
@@ -42,21 +187,18 @@ bool anti_rollback_init(void) {
 }
 
 /**
- * @brief Read current version from OTP
+ * @brief Read current version from OTP shadow
  */
 bool read_otp_version(version_t *version) {
     if (!g_anti_rollback_initialized || version == NULL) {
         return false;
     }
     
-    /* In production: Read from actual OTP memory
-     * uint32_t *otp_version = (uint32_t *)(OTP_COUNTER_BASE_ADDRESS + OTP_VERSION_COUNTER_OFFSET);
-     * version->major = (*otp_version >> 24) & 0xFF;
-     * version->minor = (*otp_version >> 16) & 0xFF;
-     * version->patch = *otp_version & 0xFFFF;
-     */
+    if (!otp_shadow_valid()) {
+        return false;  /* Shadow corrupted: fail closed */
+    }
     
-    memcpy(version, &g_otp_version, sizeof(version_t));
+    word_to_version(g_otp_shadow[OTP_SHADOW_VERSION_WORD], version);
     
     return true;
 }
@@ -103,6 +245,9 @@ bool write_otp_version(const version_t *version) {
     /* Update simulated OTP */
     memcpy(&g_otp_version, version, sizeof(version_t));
     
+    /* Write-through so the shadow tracks OTP without a re-read */
+    otp_shadow_store(OTP_SHADOW_VERSION_WORD, version_to_word(version));
+    
     return true;
 }
 
@@ -114,64 +259,126 @@ rollback_status_t check_version_rollback(const version_t *new_version) {
         return ROLLBACK_CHECK_FAIL;
     }
     
-    version_t current_version;
-    if (!read_otp_version(&current_version)) {
+    if (!otp_shadow_valid()) {
         return ROLLBACK_CHECK_FAIL;
     }
     
-    /* Compare major version */
-    if (new_version->major > current_version.major) {
-        return ROLLBACK_VERSION_HIGHER;
+    return compare_version_words(version_to_word(new_version),
+                                 g_otp_shadow[OTP_SHADOW_VERSION_WORD]);
+}
+
+/**
+ * @brief Compare firmware version against the complement mirror
+ */
+rollback_status_t check_version_rollback_mirror(const version_t *new_version) {
+    if (!g_anti_rollback_initialized || new_version == NULL) {
+        return ROLLBACK_CHECK_FAIL;
     }
     
-    if (new_version->major < current_version.major) {
-        return ROLLBACK_CHECK_FAIL;  /* Downgrade detected */
-    }
+    /* Independent copy of the OTP word: a glitch that skewed the primary
+     * comparison must also corrupt this one in the inverse sense */
+    uint32_t current_word = ~g_otp_shadow_mirror[OTP_SHADOW_VERSION_WORD];
     
-    /* Major versions equal, compare minor */
-    if (new_version->minor > current_version.minor) {
-        return ROLLBACK_VERSION_HIGHER;
+    return compare_version_words(version_to_word(new_version), current_word);
+}
+
+/**
+ * @brief Advance OTP counter to at least a target value
+ */
+bool advance_otp_counter(uint32_t counter_index, uint32_t target) {
+    if (!g_anti_rollback_initialized || counter_index >= MAX_OTP_COUNTERS) {
+        return false;
     }
     
-    if (new_version->minor < current_version.minor) {
-        return ROLLBACK_CHECK_FAIL;  /* Downgrade detected */
+    if (target > OTP_COUNTER_MAX_VALUE) {
+        return false;  /* Would exhaust the counter */
     }
     
-    /* Major and minor equal, compare patch */
-    if (new_version->patch > current_version.patch) {
-        return ROLLBACK_VERSION_HIGHER;
+    uint32_t *words = g_otp_counters[counter_index];
+    uint32_t value = otp_counter_decode(words);
+    
+    /* Fill the lowest clear bits, at most one program operation per word */
+    for (uint32_t w = 0; w < OTP_COUNTER_WORDS && value < target; w++) {
+        uint32_t clear = ~words[w];
+        uint32_t bits = 0;
+        
+        while (clear != 0 && value < target) {
+            uint32_t lowest = clear & (0U - clear);
+            bits |= lowest;
+            clear &= ~lowest;
+            value++;
+        }
+        
+        if (bits != 0) {
+            otp_program_counter_word(counter_index, w, bits);
+        }
     }
     
-    if (new_version->patch < current_version.patch) {
-        return ROLLBACK_CHECK_FAIL;  /* Downgrade detected */
-    }
+    /* Shadow takes the read-back value, not the intended one */
+    value = otp_counter_decode(words);
+    otp_shadow_store(OTP_SHADOW_COUNTER_WORD + counter_index, value);
     
-    /* Versions are equal */
-    return ROLLBACK_VERSION_EQUAL;
+    return value >= target;
 }
 
 /**
  * @brief Increment OTP counter (monotonic)
  */
 bool increment_otp_counter(uint32_t counter_index) {
-    if (!g_anti_rollback_initialized || counter_index >= MAX_OTP_COUNTERS) {
+    uint32_t value;
+    
+    if (!read_otp_counter(counter_index, &value)) {
         return false;
     }
     
-    /* In production: Increment actual OTP counter
-     * OTP counters are implemented as chains of bits that can only transition 0->1
-     * Incrementing means programming the next bit in the chain
-     * 
-     * Reference: EFR32 OTP Counter Implementation
-     */
+    return advance_otp_counter(counter_index, value + 1);
+}
+
+/**
+ * @brief Get remaining increments before a counter is exhausted
+ */
+uint32_t otp_counter_remaining(uint32_t counter_index) {
+    uint32_t value;
     
-    /* Simulated increment */
-    if (g_otp_counters[counter_index] < 0xFFFFFFFF) {
-        g_otp_counters[counter_index]++;
-        return true;
+    if (!read_otp_counter(counter_index, &value)) {
+        return 0;
     }
     
-    return false;  /* Counter overflow */
+    return OTP_COUNTER_MAX_VALUE - value;
+}
+
+/**
+ * @brief Check a firmware security epoch against the OTP epoch
+ */
+rollback_status_t check_security_epoch(uint32_t epoch) {
+    uint32_t current;
+    
+    if (!read_otp_counter(OTP_EPOCH_COUNTER, &current)) {
+        return ROLLBACK_CHECK_FAIL;
+    }
+    
+    /* Past the counter: could boot, but never be committed as the floor */
+    if (epoch > OTP_COUNTER_MAX_VALUE) {
+        return ROLLBACK_CHECK_FAIL;
+    }
+    
+    if (epoch > current) {
+        return ROLLBACK_VERSION_HIGHER;
+    }
+    
+    if (epoch < current) {
+        return ROLLBACK_CHECK_FAIL;  /* Image predates a security fix */
+    }
+    
+    return ROLLBACK_VERSION_EQUAL;
+}
+
+/**
+ * @brief Commit a security epoch to OTP
+ */
+bool commit_security_epoch(uint32_t epoch) {
+    /* Equal or lower epochs cost nothing: no bits are programmed */
+    return advance_otp_counter(OTP_EPOCH_COUNTER, epoch);
 }
 
 /**
@@ -182,12 +389,12 @@ bool read_otp_counter(uint32_t counter_index, uint32_t *value) {
         return false;
     }
     
-    /* In production: Read from actual OTP memory
-     * uint32_t *otp_counter = (uint32_t *)(OTP_COUNTER_BASE_ADDRESS + (counter_index * 4));
-     * *value = popcount(*otp_counter);  // Count number of 1 bits
-     */
+    if (!otp_shadow_valid()) {
+        return false;
+    }
     
-    *value = g_otp_counters[counter_index];
+    /* Decoded at init by otp_shadow_load() */
+    *value = g_otp_shadow[OTP_SHADOW_COUNTER_WORD + counter_index];
     
     return true;
 }
@@ -202,9 +409,7 @@ rollback_status_t verify_firmware_version(uint32_t firmware_version) {
     
     /* Extract version components from packed format */
     version_t new_version;
-    new_version.major = (firmware_version >> 24) & 0xFF;
-    new_version.minor = (firmware_version >> 16) & 0xFF;
-    new_version.patch = firmware_version & 0xFFFF;
+    word_to_version(firmware_version, &new_version);
     
     /* Check against OTP version */
     rollback_status_t status = check_version_rollback(&new_version);
@@ -216,3 +421,40 @@ rollback_status_t verify_firmware_version(uint32_t firmware_version) {
     
     return ROLLBACK_CHECK_PASS;
 }
+
+/**
+ * @brief Copy the OTP shadow out for a warm-resume snapshot
+ */
+bool anti_rollback_export_shadow(uint32_t *words, uint32_t count) {
+    if (!g_anti_rollback_initialized || words == NULL || count < OTP_SHADOW_WORDS) {
+        return false;
+    }
+    
+    if (!otp_shadow_valid()) {
+        return false;
+    }
+    
+    memcpy(words, g_otp_shadow, sizeof(g_otp_shadow));
+    
+    return true;
+}
+
+/**
+ * @brief Initialize from an authenticated shadow instead of reading OTP
+ */
+bool anti_rollback_resume(const uint32_t *words, uint32_t count) {
+    if (words == NULL || count != OTP_SHADOW_WORDS) {
+        return false;
+    }
+    
+    /* Same layout and protection as otp_shadow_load(), minus the OTP pass */
+    for (uint32_t i = 0; i < OTP_SHADOW_WORDS; i++) {
+        g_otp_shadow[i] = words[i];
+        g_otp_shadow_mirror[i] = ~words[i];
+    }
+    g_otp_shadow_crc = otp_shadow_crc32(g_otp_shadow, OTP_SHADOW_WORDS);
+    
+    g_anti_rollback_initialized = true;
+    
+    return true;
+}
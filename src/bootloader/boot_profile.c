@@ -0,0 +1,156 @@
+/**
+ * @file boot_profile.c
+ * @brief Boot-Time Cycle Count Instrumentation Implementation
+ * 
+ * Uses the Cortex-M33 DWT cycle counter to time each secure boot phase.
+ * Jitter delays are timed separately so regressions can be attributed to
+ * crypto, OTP access or jitter.
+ */
+
+#include "boot_profile.h"
+#include "attestation.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_CMSE)
+/* Cortex-M33 debug registers */
+#define DEMCR           (*(volatile uint32_t *)0xE000EDFCUL)
+#define DWT_CTRL        (*(volatile uint32_t *)0xE0001000UL)
+#define DWT_CYCCNT      (*(volatile uint32_t *)0xE0001004UL)
+#else
+/* Simulated cycle counter for host builds */
+static volatile uint32_t DWT_CYCCNT = 0;
+#endif
+
+#define DEMCR_TRCENA        (1UL << 24)
+#define DWT_CTRL_CYCCNTENA  (1UL << 0)
+
+/**
+ * @brief Read the DWT cycle counter
+ */
+uint32_t boot_profile_cycles(void) {
+    return DWT_CYCCNT;
+}
+
+#ifdef BOOT_PROFILE_ENABLED
+
+/* Phase names for event log export */
+static const char *const k_phase_names[BOOT_PHASE_COUNT] = {
+    "profile:total", "profile:init", "profile:tokens",
+    "profile:signature", "profile:rollback"
+};
+
+/* Fixed profile table in RAM */
+static boot_phase_record_t g_profile[BOOT_PHASE_COUNT];
+static uint32_t g_active_phase = BOOT_PHASE_TOTAL;
+static uint32_t g_jitter_start;
+
+/**
+ * @brief Enable DWT cycle counter and clear the profile table
+ */
+void boot_profile_init(void) {
+    memset(g_profile, 0, sizeof(g_profile));
+    g_active_phase = BOOT_PHASE_TOTAL;
+    
+    /* Enable trace and start the cycle counter from zero */
+#if defined(__ARM_FEATURE_CMSE)
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#else
+    DWT_CYCCNT = 0;
+#endif
+}
+
+/**
+ * @brief Mark start of a boot phase
+ */
+void boot_profile_phase_start(boot_phase_t phase) {
+    if (phase >= BOOT_PHASE_COUNT) {
+        return;
+    }
+    
+    g_profile[phase].parent = g_active_phase;
+    g_profile[phase].jitter_cycles = 0;
+    g_profile[phase].start_cycles = DWT_CYCCNT;
+    g_active_phase = phase;
+}
+
+/**
+ * @brief Mark end of a boot phase
+ */
+void boot_profile_phase_end(boot_phase_t phase) {
+    if (phase >= BOOT_PHASE_COUNT) {
+        return;
+    }
+    
+    g_profile[phase].end_cycles = DWT_CYCCNT;
+    
+    if (g_active_phase == phase) {
+        g_active_phase = g_profile[phase].parent;
+    }
+}
+
+/**
+ * @brief Mark start of a jitter delay
+ */
+void boot_profile_jitter_begin(void) {
+    g_jitter_start = DWT_CYCCNT;
+}
+
+/**
+ * @brief Mark end of a jitter delay and charge it to the active phase
+ */
+void boot_profile_jitter_end(void) {
+    uint32_t elapsed = DWT_CYCCNT - g_jitter_start;
+    
+    g_profile[g_active_phase].jitter_cycles += elapsed;
+    
+    /* Nested phases also roll up into the total */
+    if (g_active_phase != BOOT_PHASE_TOTAL) {
+        g_profile[BOOT_PHASE_TOTAL].jitter_cycles += elapsed;
+    }
+}
+
+/**
+ * @brief Get profile record for a phase
+ */
+const boot_phase_record_t *boot_profile_get(boot_phase_t phase) {
+    if (phase >= BOOT_PHASE_COUNT) {
+        return NULL;
+    }
+    
+    return &g_profile[phase];
+}
+
+/**
+ * @brief Export profile table to attestation event log
+ * 
+ * One event per phase: event_data carries the work cycles (jitter
+ * excluded), the description names the phase and the payload carries
+ * the jitter cycles (little-endian).
+ */
+bool boot_profile_export(void) {
+    uint8_t payload[4];
+    bool all_logged = true;
+    
+    for (uint32_t i = 0; i < BOOT_PHASE_COUNT; i++) {
+        const boot_phase_record_t *r = &g_profile[i];
+        uint32_t elapsed = r->end_cycles - r->start_cycles;
+        uint32_t work = (elapsed > r->jitter_cycles) ? (elapsed - r->jitter_cycles) : 0;
+        
+        uint8_t string_id = attestation_intern_string(k_phase_names[i]);
+        
+        for (uint32_t b = 0; b < sizeof(payload); b++) {
+            payload[b] = (uint8_t)(r->jitter_cycles >> (b * 8));
+        }
+        
+        if (!add_event_log_entry_id(BOOT_PROFILE_EVENT_TYPE, work, string_id,
+                                    payload, sizeof(payload))) {
+            all_logged = false;
+        }
+    }
+    
+    return all_logged;
+}
+
+#endif /* BOOT_PROFILE_ENABLED */
@@ -0,0 +1,115 @@
+/**
+ * @file boot_sched.c
+ * @brief Cooperative Boot Job Scheduler Implementation
+ * 
+ * Jobs poll hardware status flags rather than waiting on interrupts, so
+ * join spins through the scheduler instead of sleeping with WFE.
+ */
+
+#include "boot_sched.h"
+#include <stddef.h>
+#include <string.h>
+
+static boot_job_t *g_sched_jobs[BOOT_SCHED_MAX_JOBS];
+static bool g_sched_polling = false;
+
+/**
+ * @brief Drop all jobs
+ */
+void boot_sched_reset(void) {
+    memset(g_sched_jobs, 0, sizeof(g_sched_jobs));
+    g_sched_polling = false;
+}
+
+/**
+ * @brief Submit a job; its first step runs immediately
+ */
+bool boot_sched_submit(boot_job_t *job, boot_job_step_t step, void *ctx) {
+    if (job == NULL || step == NULL) {
+        return false;
+    }
+    
+    job->step = step;
+    job->ctx = ctx;
+    job->status = BOOT_JOB_PENDING;
+    
+    for (uint32_t i = 0; i < BOOT_SCHED_MAX_JOBS; i++) {
+        if (g_sched_jobs[i] == NULL) {
+            g_sched_jobs[i] = job;
+            
+            /* Issue the hardware request right away */
+            g_sched_polling = true;
+            job->status = step(ctx);
+            g_sched_polling = false;
+            
+            return true;
+        }
+    }
+    
+    job->status = BOOT_JOB_FAILED;
+    return false;
+}
+
+/**
+ * @brief Step every pending job once
+ */
+uint32_t boot_sched_poll(void) {
+    uint32_t pending = 0;
+    
+    if (g_sched_polling) {
+        return 0;  /* Called from inside a step */
+    }
+    
+    g_sched_polling = true;
+    
+    for (uint32_t i = 0; i < BOOT_SCHED_MAX_JOBS; i++) {
+        boot_job_t *job = g_sched_jobs[i];
+        
+        /* Completed jobs keep their slot until reset so join_all sees them */
+        if (job == NULL || job->status != BOOT_JOB_PENDING) {
+            continue;
+        }
+        
+        job->status = job->step(job->ctx);
+        
+        if (job->status == BOOT_JOB_PENDING) {
+            pending++;
+        }
+    }
+    
+    g_sched_polling = false;
+    
+    return pending;
+}
+
+/**
+ * @brief Run the scheduler until a job completes
+ */
+boot_job_status_t boot_sched_join(boot_job_t *job) {
+    if (job == NULL) {
+        return BOOT_JOB_FAILED;
+    }
+    
+    while (job->status == BOOT_JOB_PENDING) {
+        (void)boot_sched_poll();
+    }
+    
+    return job->status;
+}
+
+/**
+ * @brief Run the scheduler until every job completes
+ */
+bool boot_sched_join_all(void) {
+    bool ok = true;
+    
+    for (uint32_t i = 0; i < BOOT_SCHED_MAX_JOBS; i++) {
+        boot_job_t *job = g_sched_jobs[i];
+        
+        if (job != NULL && boot_sched_join(job) != BOOT_JOB_DONE) {
+            ok = false;
+        }
+    }
+    
+    return ok;
+}
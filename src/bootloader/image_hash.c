@@ -0,0 +1,286 @@
+/**
+ * @file image_hash.c
+ * @brief Streaming Firmware Image Hashing Implementation
+ * 
+ * Implements chunked SHA-256 over firmware images with a double-buffered
+ * LDMA -> Secure Vault pipeline and a plain CPU fallback.
+ */
+
+#include "image_hash.h"
+#include <string.h>
+#if defined(SIM_PERIPH_MOCK)
+#include "mock_periph.h"
+#endif
+
+/* Double-buffered chunk storage in Secure RAM (word aligned for LDMA) */
+static uint8_t g_chunk_buffer[2][IMAGE_HASH_CHUNK_SIZE] __attribute__((aligned(4)));
+
+/* Simulated peripheral state (in production, use LDMA and SEMAILBOX registers) */
+static volatile uint32_t LDMA_CHDONE = 0;
+#if defined(SIM_PERIPH_MOCK)
+#define SEMAILBOX_BUSY  (g_mock_periph.semailbox_busy)
+#else
+static volatile uint32_t SEMAILBOX_BUSY = 0;
+#endif
+static sha256_context_t g_se_hash_state;
+
+/**
+ * @brief Start LDMA transfer of one chunk from flash into a RAM buffer
+ */
+static void ldma_start_chunk(uint8_t *dst, const uint8_t *src, uint32_t len) {
+    /* In production: Program an M2M word-transfer descriptor and start channel
+     * Reference: EFR32MG26 Reference Manual, LDMA chapter
+     * 
+     * desc.xfer.srcAddr  = (uint32_t)src;
+     * desc.xfer.dstAddr  = (uint32_t)dst;
+     * desc.xfer.xferCnt  = (len / 4) - 1;
+     * LDMA->LINKLOAD     = 1 << IMAGE_HASH_LDMA_CH;
+     */
+    
+    /* Simulated transfer */
+    memcpy(dst, src, len);
+    LDMA_CHDONE = 1;
+}
+
+/**
+ * @brief Check for completion of the in-flight LDMA chunk transfer
+ */
+static bool ldma_chunk_done(void) {
+    /* In production: LDMA->CHDONE & (1 << IMAGE_HASH_LDMA_CH), then CHDONE_CLR */
+    if (LDMA_CHDONE == 0) {
+        return false;
+    }
+    LDMA_CHDONE = 0;
+    return true;
+}
+
+/**
+ * @brief Open a streaming SHA-256 operation on the Secure Vault
+ */
+static void se_hash_start(void) {
+    /* In production: SE_COMMAND_HASH with SE_COMMAND_OPTION_HASH_SHA256,
+     * streaming mode, state kept inside the SE between updates */
+    sha256_init(&g_se_hash_state);
+}
+
+/**
+ * @brief Submit one chunk to the Secure Vault hash engine (non-blocking)
+ */
+static void se_hash_submit(const uint8_t *chunk, uint32_t len) {
+    /* In production: SE_COMMAND_HASHUPDATE with the chunk buffer as input
+     * data; SEMAILBOX_HOST->TX_HEADER is written and the call returns while
+     * the SE consumes the buffer */
+    SEMAILBOX_BUSY = 1;
+    sha256_update(&g_se_hash_state, chunk, len);
+    SEMAILBOX_BUSY = 0;
+}
+
+/**
+ * @brief Check whether the Secure Vault still holds the submitted chunk
+ */
+static bool se_hash_busy(void) {
+    /* In production: !(SEMAILBOX_HOST->RX_STATUS & SEMAILBOX_RX_STATUS_RXINT) */
+    return SEMAILBOX_BUSY != 0;
+}
+
+/**
+ * @brief Close the streaming SHA-256 operation and read out the digest
+ */
+static void se_hash_finish(uint8_t *digest) {
+    /* In production: SE_COMMAND_HASHFINISH, digest returned in output buffer */
+    sha256_final(&g_se_hash_state, digest);
+}
+
+/**
+ * @brief Next chunk length from an offset
+ */
+static uint32_t image_hash_chunk_len(const image_hash_job_t *job, uint32_t offset) {
+    uint32_t len = job->image_size - offset;
+    return (len > IMAGE_HASH_CHUNK_SIZE) ? IMAGE_HASH_CHUNK_SIZE : len;
+}
+
+/**
+ * @brief Hash one chunk on the CPU
+ */
+static boot_job_status_t image_hash_cpu_step(image_hash_job_t *job) {
+    if (job->offset < job->image_size) {
+        uint32_t len = image_hash_chunk_len(job, job->offset);
+        sha256_update(&job->cpu, job->image + job->offset, len);
+        job->offset += len;
+        return BOOT_JOB_PENDING;
+    }
+    
+    sha256_final(&job->cpu, job->digest);
+    return BOOT_JOB_DONE;
+}
+
+/**
+ * @brief Advance the double-buffered LDMA -> SE pipeline
+ * 
+ * While the SE hashes buffer N, LDMA is already filling buffer N+1
+ * from flash, so flash read latency is hidden behind hashing. A buffer
+ * is only refilled once the SE has released it.
+ */
+static boot_job_status_t image_hash_pipelined_step(image_hash_job_t *job) {
+    if (!job->chunk_ready) {
+        if (!ldma_chunk_done()) {
+            return BOOT_JOB_PENDING;
+        }
+        job->chunk_ready = true;
+    }
+    
+    if (se_hash_busy()) {
+        return BOOT_JOB_PENDING;
+    }
+    
+    if (job->offset >= job->image_size) {
+        se_hash_finish(job->digest);
+        
+        /* Image data in the chunk buffers is no longer needed */
+        memset(g_chunk_buffer, 0, sizeof(g_chunk_buffer));
+        return BOOT_JOB_DONE;
+    }
+    
+    uint32_t next_offset = job->offset + job->len;
+    uint32_t next_len = 0;
+    
+    /* Kick off the read of the next chunk into the other buffer */
+    if (next_offset < job->image_size) {
+        next_len = image_hash_chunk_len(job, next_offset);
+        ldma_start_chunk(g_chunk_buffer[job->current ^ 1], job->image + next_offset, next_len);
+        job->chunk_ready = false;
+    }
+    
+    /* Hash the current chunk while the transfer runs */
+    se_hash_submit(g_chunk_buffer[job->current], job->len);
+    
+    job->offset = next_offset;
+    job->len = next_len;
+    job->current ^= 1;
+    
+    return BOOT_JOB_PENDING;
+}
+
+/**
+ * @brief Start a resumable image hash
+ */
+bool image_hash_begin(image_hash_job_t *job, const uint8_t *image, uint32_t image_size,
+                      image_hash_backend_t backend, uint8_t *digest) {
+    if (job == NULL || image == NULL || digest == NULL || image_size == 0) {
+        return false;
+    }
+    
+    memset(job, 0, sizeof(*job));
+    job->image = image;
+    job->image_size = image_size;
+    job->backend = backend;
+    job->digest = digest;
+    
+    switch (backend) {
+    case IMAGE_HASH_BACKEND_CPU:
+        sha256_init(&job->cpu);
+        return true;
+    
+    case IMAGE_HASH_BACKEND_SE_PIPELINED:
+        se_hash_start();
+        
+        /* Prime the pipeline with the first chunk */
+        job->len = image_hash_chunk_len(job, 0);
+        ldma_start_chunk(g_chunk_buffer[0], image, job->len);
+        return true;
+    
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Advance a resumable image hash without blocking
+ */
+boot_job_status_t image_hash_step(image_hash_job_t *job) {
+    if (job == NULL) {
+        return BOOT_JOB_FAILED;
+    }
+    
+    if (job->backend == IMAGE_HASH_BACKEND_CPU) {
+        return image_hash_cpu_step(job);
+    }
+    
+    return image_hash_pipelined_step(job);
+}
+
+/**
+ * @brief Open a streaming image hash
+ */
+bool image_hash_stream_start(image_hash_stream_t *stream, image_hash_backend_t backend) {
+    if (stream == NULL) {
+        return false;
+    }
+    
+    stream->backend = backend;
+    
+    switch (backend) {
+    case IMAGE_HASH_BACKEND_CPU:
+        sha256_init(&stream->cpu);
+        return true;
+    
+    case IMAGE_HASH_BACKEND_SE_PIPELINED:
+        se_hash_start();
+        return true;
+    
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Feed data to a streaming image hash
+ */
+void image_hash_stream_update(image_hash_stream_t *stream, const uint8_t *data, uint32_t len) {
+    if (len == 0) {
+        return;
+    }
+    
+    if (stream->backend == IMAGE_HASH_BACKEND_CPU) {
+        sha256_update(&stream->cpu, data, len);
+        return;
+    }
+    
+    /* The previous buffer must be released before the next is queued */
+    while (se_hash_busy()) {
+    }
+    se_hash_submit(data, len);
+}
+
+/**
+ * @brief Close a streaming image hash
+ */
+void image_hash_stream_finish(image_hash_stream_t *stream, uint8_t *digest) {
+    if (stream->backend == IMAGE_HASH_BACKEND_CPU) {
+        sha256_final(&stream->cpu, digest);
+        return;
+    }
+    
+    while (se_hash_busy()) {
+    }
+    se_hash_finish(digest);
+}
+
+/**
+ * @brief Compute SHA-256 of a firmware image
+ */
+bool image_hash_compute(const uint8_t *image, uint32_t image_size,
+                        image_hash_backend_t backend, uint8_t *digest) {
+    image_hash_job_t job;
+    boot_job_status_t status;
+    
+    if (!image_hash_begin(&job, image, image_size, backend, digest)) {
+        return false;
+    }
+    
+    do {
+        status = image_hash_step(&job);
+    } while (status == BOOT_JOB_PENDING);
+    
+    return status == BOOT_JOB_DONE;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file image_lz4.c
+ * @brief LZ4-Compressed Firmware Image Implementation
+ * 
+ * Safe LZ4 block decoder: literal and match lengths, offsets and the
+ * output position are checked against the input record, the block end
+ * and the start of the image before any byte is copied. The block just
+ * decoded is submitted to the hash engine before the next one is decoded;
+ * with the SE backend the two overlap.
+ */
+
+#include "image_lz4.h"
+#include "trustzone.h"
+#include <stddef.h>
+#include <string.h>
+
+#define LZ4_MIN_MATCH       4
+#define LZ4_LEN_EXTENDED    15
+
+/**
+ * @brief Read an LZ4 length extension (bytes of 255 continue it)
+ */
+static bool lz4_read_length(const uint8_t **ip, const uint8_t *ip_end, uint32_t *len) {
+    uint8_t b;
+    
+    do {
+        if (*ip >= ip_end) {
+            return false;
+        }
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255);
+    
+    return true;
+}
+
+/**
+ * @brief Decode one LZ4 block to exactly out_len bytes at base + pos
+ */
+static bool lz4_decode_block(const uint8_t *in, uint32_t in_len,
+                             uint8_t *base, uint32_t pos, uint32_t out_len) {
+    const uint8_t *ip = in;
+    const uint8_t *ip_end = in + in_len;
+    uint8_t *op = base + pos;
+    uint8_t *op_end = op + out_len;
+    
+    while (ip < ip_end) {
+        uint32_t token = *ip++;
+        uint32_t lit = token >> 4;
+        
+        if (lit == LZ4_LEN_EXTENDED && !lz4_read_length(&ip, ip_end, &lit)) {
+            return false;
+        }
+        if (lit > (uint32_t)(ip_end - ip) || lit > (uint32_t)(op_end - op)) {
+            return false;
+        }
+        memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+        
+        /* The last sequence has literals only */
+        if (ip == ip_end) {
+            break;
+        }
+        
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        uint32_t offset = (uint32_t)ip[0] | ((uint32_t)ip[1] << 8);
+        ip += 2;
+        
+        uint32_t match = (token & 0x0F) + LZ4_MIN_MATCH;
+        if ((token & 0x0F) == LZ4_LEN_EXTENDED && !lz4_read_length(&ip, ip_end, &match)) {
+            return false;
+        }
+        
+        if (offset == 0 || offset > (uint32_t)(op - base) || match > (uint32_t)(op_end - op)) {
+            return false;
+        }
+        
+        const uint8_t *src = op - offset;
+        if (offset >= match) {
+            memcpy(op, src, match);
+            op += match;
+        } else {
+            /* Overlapping copy repeats the last offset bytes */
+            for (uint32_t i = 0; i < match; i++) {
+                *op++ = *src++;
+            }
+        }
+    }
+    
+    return op == op_end;
+}
+
+/**
+ * @brief Decompress a block stream and hash the output in the same pass
+ */
+bool image_lz4_decompress(const image_lz4_ext_t *ext, uint8_t *dest, uint32_t image_size,
+                          image_hash_backend_t backend, uint8_t *digest) {
+    image_hash_stream_t stream;
+    
+    if (ext == NULL || dest == NULL || digest == NULL || image_size == 0) {
+        return false;
+    }
+    
+    /* Known block geometry, and no more stream than a slot holds */
+    uint32_t log2 = ext->block_log2;
+    if (log2 < IMAGE_LZ4_BLOCK_LOG2_MIN || log2 > IMAGE_LZ4_BLOCK_LOG2_MAX ||
+        ext->compressed_size > FIRMWARE_MAX_IMAGE_SIZE) {
+        return false;
+    }
+    
+    if (!image_hash_stream_start(&stream, backend)) {
+        return false;
+    }
+    
+    const uint8_t *ip = (const uint8_t *)ext + sizeof(image_lz4_ext_t);
+    const uint8_t *ip_end = ip + ext->compressed_size;
+    uint32_t block_size = 1UL << log2;
+    uint32_t pos = 0;
+    
+    while (pos < image_size) {
+        uint32_t out_len = image_size - pos;
+        if (out_len > block_size) {
+            out_len = block_size;
+        }
+        
+        if (ip_end - ip < 4) {
+            break;
+        }
+        uint32_t record = (uint32_t)ip[0] | ((uint32_t)ip[1] << 8) |
+                          ((uint32_t)ip[2] << 16) | ((uint32_t)ip[3] << 24);
+        uint32_t len = record & IMAGE_LZ4_BLOCK_LEN_MASK;
+        ip += 4;
+        
+        if (len > (uint32_t)(ip_end - ip)) {
+            break;
+        }
+        
+        if (record & IMAGE_LZ4_BLOCK_STORED) {
+            if (len != out_len) {
+                break;
+            }
+            memcpy(dest + pos, ip, len);
+        } else if (!lz4_decode_block(ip, len, dest, pos, out_len)) {
+            break;
+        }
+        
+        /* Hashed from where it was just written, while the next block decodes */
+        image_hash_stream_update(&stream, dest + pos, out_len);
+        
+        ip += len;
+        pos += out_len;
+    }
+    
+    image_hash_stream_finish(&stream, digest);
+    
+    /* The whole stream, and nothing but the stream, makes up the image */
+    if (pos != image_size || ip != ip_end) {
+        memset(dest, 0, image_size);
+        memset(digest, 0, SHA256_DIGEST_SIZE);
+        return false;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Decompress a flagged image to its load_address and hash it
+ */
+bool image_lz4_load(const firmware_header_t *header, const uint8_t *image, uint8_t *digest) {
+    if (header == NULL || image == NULL || digest == NULL) {
+        return false;
+    }
+    
+    const image_lz4_ext_t *ext = (const image_lz4_ext_t *)image;
+    uint32_t load = header->load_address;
+    uint32_t size = header->image_size;
+    
+    /* Output lands in Non-Secure SRAM only */
+    if (size == 0 || load < IMAGE_LZ4_SRAM_START || load > IMAGE_LZ4_SRAM_END ||
+        size > IMAGE_LZ4_SRAM_END - load || is_range_secure(load, size)) {
+        return false;
+    }
+    
+    return image_lz4_decompress(ext, (uint8_t *)(uintptr_t)load, size,
+                                IMAGE_HASH_DEFAULT_BACKEND, digest);
+}
+
+/**
+ * @brief Get the bytes an LZ4 image occupies after the header
+ */
+uint32_t image_lz4_stored_size(const firmware_header_t *header, const uint8_t *image) {
+    if (header == NULL || image == NULL) {
+        return 0;
+    }
+    
+    const image_lz4_ext_t *ext = (const image_lz4_ext_t *)image;
+    if (ext->compressed_size == 0 || ext->compressed_size > FIRMWARE_MAX_IMAGE_SIZE) {
+        return 0;
+    }
+    
+    return sizeof(image_lz4_ext_t) + ext->compressed_size;
+}
@@ -0,0 +1,340 @@
+/**
+ * @file image_merkle.c
+ * @brief Segmented Firmware Image Implementation
+ * 
+ * The root is folded from the leaf table with a log-depth stack (one entry
+ * per tree level) so no per-level scratch copy of the leaves is needed:
+ * pairs combine left to right and an odd node is promoted unchanged.
+ * Leaves are H(0x00 || index || segment), nodes H(0x01 || left || right).
+ */
+
+#include "image_merkle.h"
+#include "image_hash.h"
+#include "image_lz4.h"
+#include <string.h>
+
+#define MERKLE_STACK_DEPTH  9   /* log2(IMAGE_MERKLE_MAX_SEGMENTS) + 1 */
+#define MERKLE_WORDS        ((IMAGE_MERKLE_MAX_SEGMENTS + 31) / 32)
+
+/* Leaf table of the armed image, copied out of the Non-Secure slot so that
+ * the leaves checked against the root are the ones segments are checked
+ * against later */
+static uint8_t g_merkle_leaf_table[IMAGE_MERKLE_MAX_SEGMENTS * SHA256_DIGEST_SIZE];
+
+/* Armed image (root already checked against the signed header hash) */
+static const uint8_t *g_merkle_leaves = NULL;
+static const uint8_t *g_merkle_data = NULL;
+static uint32_t g_merkle_data_addr = 0;     /* load_address of segment 0 */
+static uint32_t g_merkle_size = 0;
+static uint32_t g_merkle_log2 = 0;
+static uint32_t g_merkle_count = 0;
+static uint32_t g_merkle_next = 0;          /* Background scan cursor */
+static uint32_t g_merkle_pending = 0;
+
+/* Verified segments; mirrored by the simulated MPC lookup table below */
+static uint32_t g_merkle_verified[MERKLE_WORDS];
+
+/* Simulated MPC block lookup table: 1 = Non-Secure accessible
+ * (in production, the SMU/MPC LUT covering the Non-Secure flash slot) */
+static volatile uint32_t MPC_BLK_LUT[MERKLE_WORDS];
+
+/**
+ * @brief Hash an interior node
+ */
+static void merkle_node(const uint8_t *left, const uint8_t *right, uint8_t *out) {
+    static const uint8_t prefix = IMAGE_MERKLE_NODE_PREFIX;
+    sha256_context_t ctx;
+    
+    sha256_init(&ctx);
+    sha256_update(&ctx, &prefix, 1);
+    sha256_update(&ctx, left, SHA256_DIGEST_SIZE);
+    sha256_update(&ctx, right, SHA256_DIGEST_SIZE);
+    sha256_final(&ctx, out);
+}
+
+/**
+ * @brief Fold the leaf table into the root
+ */
+static void merkle_root(const uint8_t *leaves, uint32_t count, uint8_t *root) {
+    uint8_t stack[MERKLE_STACK_DEPTH][SHA256_DIGEST_SIZE];
+    uint8_t level[MERKLE_STACK_DEPTH];
+    uint32_t depth = 0;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(stack[depth], &leaves[i * SHA256_DIGEST_SIZE], SHA256_DIGEST_SIZE);
+        level[depth++] = 0;
+        
+        /* Complete subtrees combine as soon as both halves exist */
+        while (depth >= 2 && level[depth - 1] == level[depth - 2]) {
+            merkle_node(stack[depth - 2], stack[depth - 1], stack[depth - 2]);
+            level[depth - 2]++;
+            depth--;
+        }
+    }
+    
+    /* Remaining right edge: promoted odd nodes fold in from the top */
+    while (depth >= 2) {
+        merkle_node(stack[depth - 2], stack[depth - 1], stack[depth - 2]);
+        depth--;
+    }
+    
+    memcpy(root, stack[0], SHA256_DIGEST_SIZE);
+    memset(stack, 0, sizeof(stack));
+}
+
+/**
+ * @brief Block every segment of the armed image
+ */
+static void merkle_block_all(void) {
+    memset(g_merkle_verified, 0, sizeof(g_merkle_verified));
+    
+    /* In production: clear the LUT bits for the slot so Non-Secure
+     * fetches and reads fault into image_merkle_fault_handler() */
+    for (uint32_t w = 0; w < MERKLE_WORDS; w++) {
+        MPC_BLK_LUT[w] = 0;
+    }
+}
+
+/**
+ * @brief Check a segment descriptor against the header
+ * @return uint32_t Segment count, or 0 if the descriptor is invalid
+ */
+static uint32_t merkle_ext_count(const firmware_header_t *header, const image_merkle_ext_t *ext) {
+    uint32_t log2 = ext->segment_log2;
+    uint32_t count = ext->segment_count;
+    
+    if (log2 < IMAGE_MERKLE_SEGMENT_LOG2_MIN || log2 > IMAGE_MERKLE_SEGMENT_LOG2_MAX) {
+        return 0;
+    }
+    
+    /* Exactly enough leaves to cover image_size */
+    uint32_t expected = (header->image_size + (1UL << log2) - 1) >> log2;
+    if (count == 0 || count != expected || count > IMAGE_MERKLE_MAX_SEGMENTS) {
+        return 0;
+    }
+    
+    return count;
+}
+
+/**
+ * @brief Compute the image digest the signature covers
+ */
+bool firmware_image_digest(const firmware_header_t *header, const uint8_t *image,
+                           uint8_t *digest) {
+    if (header == NULL || image == NULL || digest == NULL) {
+        return false;
+    }
+    
+    if ((header->flags & FIRMWARE_FLAG_LZ4) != 0) {
+        /* Decompressed into RAM; segments are a flash-slot notion */
+        if ((header->flags & FIRMWARE_FLAG_MERKLE) != 0) {
+            return false;
+        }
+        return image_lz4_load(header, image, digest);
+    }
+    
+    if ((header->flags & FIRMWARE_FLAG_MERKLE) == 0) {
+        return image_hash_compute(image, header->image_size,
+                                  IMAGE_HASH_DEFAULT_BACKEND, digest);
+    }
+    
+    /* Descriptor read once; the slot stays Non-Secure writable */
+    image_merkle_ext_t ext;
+    memcpy(&ext, image, sizeof(ext));
+    uint32_t log2 = ext.segment_log2;
+    uint32_t count = merkle_ext_count(header, &ext);
+    
+    if (count == 0) {
+        return false;
+    }
+    
+    /* Segments execute in place: the address faults resolve against must
+     * be the bytes hashed */
+    const uint8_t *data = image + sizeof(image_merkle_ext_t) + count * SHA256_DIGEST_SIZE;
+    if (header->load_address != (uint32_t)(uintptr_t)data) {
+        return false;
+    }
+    
+    merkle_block_all();
+    
+    memcpy(g_merkle_leaf_table, image + sizeof(image_merkle_ext_t), count * SHA256_DIGEST_SIZE);
+    g_merkle_leaves = g_merkle_leaf_table;
+    g_merkle_data = data;
+    g_merkle_data_addr = header->load_address;
+    g_merkle_size = header->image_size;
+    g_merkle_log2 = log2;
+    g_merkle_count = count;
+    g_merkle_next = 0;
+    g_merkle_pending = count;
+    
+    merkle_root(g_merkle_leaves, count, digest);
+    
+    return true;
+}
+
+/**
+ * @brief Get the start of executable image data
+ */
+const uint8_t *firmware_image_data(const firmware_header_t *header, const uint8_t *image) {
+    if ((header->flags & FIRMWARE_FLAG_LZ4) != 0) {
+        return (const uint8_t *)(uintptr_t)header->load_address;
+    }
+    
+    if ((header->flags & FIRMWARE_FLAG_MERKLE) == 0) {
+        return image;
+    }
+    
+    const image_merkle_ext_t *ext = (const image_merkle_ext_t *)image;
+    return image + sizeof(image_merkle_ext_t) + ext->segment_count * SHA256_DIGEST_SIZE;
+}
+
+/**
+ * @brief Get the bytes a Merkle image occupies after the header
+ */
+uint32_t image_merkle_stored_size(const firmware_header_t *header, const uint8_t *image) {
+    if (header == NULL || image == NULL) {
+        return 0;
+    }
+    
+    uint32_t count = merkle_ext_count(header, (const image_merkle_ext_t *)image);
+    if (count == 0) {
+        return 0;
+    }
+    
+    return sizeof(image_merkle_ext_t) + count * SHA256_DIGEST_SIZE + header->image_size;
+}
+
+/**
+ * @brief Get the bytes the image occupies in the slot after the header
+ */
+uint32_t firmware_image_stored_size(const firmware_header_t *header, const uint8_t *image) {
+    if (header == NULL || image == NULL || header->image_size == 0 ||
+        header->image_size > FIRMWARE_MAX_IMAGE_SIZE) {
+        return 0;
+    }
+    
+    if ((header->flags & FIRMWARE_FLAG_LZ4) != 0) {
+        return image_lz4_stored_size(header, image);
+    }
+    
+    if ((header->flags & FIRMWARE_FLAG_MERKLE) != 0) {
+        return image_merkle_stored_size(header, image);
+    }
+    
+    return header->image_size;
+}
+
+/**
+ * @brief Check whether a segment is open for Non-Secure access
+ */
+bool image_merkle_segment_verified(uint32_t index) {
+    if (index >= g_merkle_count) {
+        return false;
+    }
+    
+    return (g_merkle_verified[index / 32] & (1UL << (index % 32))) != 0;
+}
+
+/**
+ * @brief Verify one segment and open it for Non-Secure access
+ */
+bool image_merkle_verify_segment(uint32_t index) {
+    static const uint8_t prefix = IMAGE_MERKLE_LEAF_PREFIX;
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_context_t ctx;
+    volatile uint8_t diff = 0;
+    
+    if (g_merkle_leaves == NULL || index >= g_merkle_count) {
+        return false;
+    }
+    
+    if (image_merkle_segment_verified(index)) {
+        return true;
+    }
+    
+    uint32_t offset = index << g_merkle_log2;
+    uint32_t len = g_merkle_size - offset;
+    if (len > (1UL << g_merkle_log2)) {
+        len = 1UL << g_merkle_log2;
+    }
+    
+    /* Index is bound into the leaf so segments can't be swapped */
+    uint8_t index_le[4] = {
+        (uint8_t)index, (uint8_t)(index >> 8), (uint8_t)(index >> 16), (uint8_t)(index >> 24)
+    };
+    
+    sha256_init(&ctx);
+    sha256_update(&ctx, &prefix, 1);
+    sha256_update(&ctx, index_le, sizeof(index_le));
+    sha256_update(&ctx, g_merkle_data + offset, len);
+    sha256_final(&ctx, digest);
+    
+    const uint8_t *leaf = &g_merkle_leaves[index * SHA256_DIGEST_SIZE];
+    for (uint32_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        diff |= digest[i] ^ leaf[i];
+    }
+    memset(digest, 0, sizeof(digest));
+    
+    if (diff != 0) {
+        return false;  /* Segment stays blocked */
+    }
+    
+    g_merkle_verified[index / 32] |= 1UL << (index % 32);
+    g_merkle_pending--;
+    
+    /* In production: set the LUT bit, then DSB/ISB before returning to
+     * the faulting Non-Secure access */
+    MPC_BLK_LUT[index / 32] |= 1UL << (index % 32);
+    
+    return true;
+}
+
+/**
+ * @brief Verify the segments needed to start executing
+ */
+bool image_merkle_verify_boot_segments(const firmware_header_t *header) {
+    if (header == NULL || (header->flags & FIRMWARE_FLAG_MERKLE) == 0) {
+        return true;  /* Flat images were hashed in full */
+    }
+    
+    if (header->entry_point < g_merkle_data_addr ||
+        header->entry_point - g_merkle_data_addr >= g_merkle_size) {
+        return false;
+    }
+    
+    /* Vector table, then the segment holding the reset handler */
+    uint32_t entry_segment = (header->entry_point - g_merkle_data_addr) >> g_merkle_log2;
+    
+    return image_merkle_verify_segment(0) && image_merkle_verify_segment(entry_segment);
+}
+
+/**
+ * @brief Verify pending segments in the background
+ */
+uint32_t image_merkle_verify_pending(uint32_t max_segments) {
+    while (max_segments > 0 && g_merkle_pending > 0 && g_merkle_next < g_merkle_count) {
+        uint32_t index = g_merkle_next++;
+        
+        if (image_merkle_segment_verified(index)) {
+            continue;
+        }
+        
+        /* A bad segment stays blocked; its first access faults */
+        (void)image_merkle_verify_segment(index);
+        max_segments--;
+    }
+    
+    return g_merkle_pending;
+}
+
+/**
+ * @brief Resolve an access fault on a blocked segment
+ */
+bool image_merkle_fault_handler(uint32_t fault_address) {
+    if (g_merkle_leaves == NULL || fault_address < g_merkle_data_addr ||
+        fault_address - g_merkle_data_addr >= g_merkle_size) {
+        return false;
+    }
+    
+    return image_merkle_verify_segment((fault_address - g_merkle_data_addr) >> g_merkle_log2);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file jitter.c
+ * @brief Budgeted Random Jitter Scheduler Implementation
+ * 
+ * Each call site receives a guaranteed floor plus a random share of the
+ * discretionary pool. Shares are drawn up to twice the fair share of the
+ * remaining pool, so delays stay unpredictable per call while the sum can
+ * never exceed the profile budget.
+ */
+
+#include "jitter.h"
+
+/* Jitter profile table */
+static const jitter_profile_config_t k_jitter_profiles[JITTER_PROFILE_COUNT] = {
+    [JITTER_PROFILE_FACTORY] = {
+        .budget_cycles = 24000,
+        .min_cycles = 200,
+        .max_cycles = 2000,
+        .expected_calls = 24
+    },
+    [JITTER_PROFILE_FIELD] = {
+        .budget_cycles = 240000,
+        .min_cycles = 1000,
+        .max_cycles = 24000,
+        .expected_calls = 24
+    }
+};
+
+/* Per-boot scheduler state */
+static jitter_profile_t g_jitter_profile = JITTER_DEFAULT_PROFILE;
+static uint32_t g_jitter_pool;
+static uint32_t g_jitter_calls_left;
+
+/**
+ * @brief Select jitter profile and reset the per-boot budget
+ */
+bool jitter_set_profile(jitter_profile_t profile) {
+    if (profile >= JITTER_PROFILE_COUNT) {
+        return false;
+    }
+    
+    g_jitter_profile = profile;
+    jitter_budget_reset();
+    
+    return true;
+}
+
+/**
+ * @brief Reset the per-boot budget for the current profile
+ */
+void jitter_budget_reset(void) {
+    const jitter_profile_config_t *p = &k_jitter_profiles[g_jitter_profile];
+    uint32_t floor_reserve = p->min_cycles * p->expected_calls;
+    
+    /* Floors for every expected call are reserved up front */
+    g_jitter_pool = (p->budget_cycles > floor_reserve) ? (p->budget_cycles - floor_reserve) : 0;
+    g_jitter_calls_left = p->expected_calls;
+}
+
+/**
+ * @brief Draw the delay for one jitter call site from the budget
+ */
+uint32_t jitter_budget_draw(uint32_t random) {
+    const jitter_profile_config_t *p = &k_jitter_profiles[g_jitter_profile];
+    uint32_t upper;
+    uint32_t extra;
+    
+    /* Budget spent: keep desynchronizing with a bounded floor-sized delay */
+    if (g_jitter_calls_left == 0) {
+        return random % (p->min_cycles + 1);
+    }
+    
+    /* Random share of up to twice the fair share of what is left */
+    upper = (g_jitter_pool / g_jitter_calls_left) * 2;
+    if (upper > p->max_cycles - p->min_cycles) {
+        upper = p->max_cycles - p->min_cycles;
+    }
+    if (upper > g_jitter_pool) {
+        upper = g_jitter_pool;
+    }
+    
+    extra = random % (upper + 1);
+    
+    g_jitter_pool -= extra;
+    g_jitter_calls_left--;
+    
+    return p->min_cycles + extra;
+}
+
+/**
+ * @brief Get remaining jitter budget for this boot
+ */
+uint32_t jitter_budget_remaining(void) {
+    const jitter_profile_config_t *p = &k_jitter_profiles[g_jitter_profile];
+    
+    return g_jitter_pool + (g_jitter_calls_left * p->min_cycles);
+}
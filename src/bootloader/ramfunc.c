@@ -0,0 +1,35 @@
+/**
+ * @file ramfunc.c
+ * @brief RAM-Resident Hot Path Loader
+ * 
+ * Runs from flash. Section bounds come from config/efr32mg26_secure.ld.
+ */
+
+#include "ramfunc.h"
+
+#if defined(__ARM_ARCH_8M_MAIN__)
+extern const uint32_t __ramfunc_load_start[];
+extern uint32_t __ramfunc_start[];
+extern uint32_t __ramfunc_end[];
+#endif
+
+/**
+ * @brief Copy .ramfunc from its flash load address to Secure RAM
+ */
+void ramfunc_init(void) {
+#if defined(__ARM_ARCH_8M_MAIN__)
+    const uint32_t *src = __ramfunc_load_start;
+    
+    for (uint32_t *dst = __ramfunc_start; dst < __ramfunc_end; dst++) {
+        *dst = *src++;
+    }
+    
+    /* Code just written must be visible to instruction fetch */
+    __asm__ volatile ("dsb\n isb" ::: "memory");
+    
+    /* In production: lock the copy read-only and executable
+     * MPU->RNR = RAMFUNC_MPU_REGION;
+     * MPU->RBAR = (uint32_t)__ramfunc_start | MPU_RBAR_AP_RO_PRIV;
+     * MPU->RLAR = ((uint32_t)__ramfunc_end - 32) | MPU_RLAR_EN_Msk; */
+#endif
+}
@@ -11,28 +11,56 @@
 #include "anti_rollback.h"
 #include "puf.h"
 #include "trustzone.h"
+#include "image_hash.h"
+#include "image_merkle.h"
+#include "boot_profile.h"
+#include "jitter.h"
+#include "entropy_pool.h"
+#include "verify_cache.h"
+#include "boot_sched.h"
+#include "ecdsa_p256.h"
+#include <stddef.h>
 #include <string.h>
 
+/* Image digest job (runs on LDMA/SE while the CPU checks tokens and OTP) */
+typedef struct {
+    const firmware_header_t *header;
+    const uint8_t *image;
+    image_hash_job_t hash;
+    bool started;
+    uint8_t digest[SHA256_DIGEST_SIZE];
+} boot_digest_job_t;
+
 /* Global boot context */
 static boot_context_t g_boot_context;
 
-/* Simulated TRNG for random jitter (in real implementation, use hardware TRNG) */
+/* Boot jobs overlapped with the CPU-only checks */
+static boot_job_t g_puf_job;
+static boot_job_t g_digest_job;
+static boot_job_t g_tamper_job;
+static boot_digest_job_t g_digest_ctx;
+
+/* Jitter randomness is served from the TRNG entropy pool without blocking */
 static uint32_t get_trng_random(void) {
-    /* In production: Read from EFR32 TRNG peripheral
-     * For now, use a simple PRNG for demonstration */
-    static uint32_t lfsr = 0xACE1u;
-    lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
-    return lfsr;
+    return entropy_pool_get_word();
 }
 
 /**
  * @brief Inject random jitter delay for timing desynchronization
  * 
  * This prevents timing-based fault injection attacks by making the
- * execution time unpredictable.
+ * execution time unpredictable. The delay is drawn from the per-boot
+ * jitter budget so total boot latency stays bounded.
  */
 void inject_random_jitter(uint32_t seed) {
-    volatile uint32_t delay_cycles = (seed % 1000) + 100;
+    /* Advance in-flight boot jobs first; jitter time is dead time anyway */
+    (void)boot_sched_poll();
+    
+    BOOT_PROFILE_JITTER_BEGIN();
+    
+    /* Draw this call site's share of the jitter budget */
+    volatile uint32_t total_iterations = jitter_budget_draw(seed) / JITTER_CYCLES_PER_ITERATION;
+    volatile uint32_t delay_cycles = get_trng_random() % (total_iterations + 1);
     
     /* Create unpredictable delay with multiple paths */
     for (volatile uint32_t i = 0; i < delay_cycles; i++) {
@@ -42,11 +70,13 @@ void inject_random_jitter(uint32_t seed) {
         (void)dummy; /* Prevent optimization */
     }
     
-    /* Additional jitter with different pattern */
-    delay_cycles = (get_trng_random() % 500);
+    /* Remainder of the share with a different pattern */
+    delay_cycles = total_iterations - delay_cycles;
     for (volatile uint32_t j = 0; j < delay_cycles; j++) {
         __asm__ volatile ("nop");
     }
+    
+    BOOT_PROFILE_JITTER_END();
 }
 
 /**
@@ -126,42 +156,72 @@ uint32_t verify_layered_tokens(boot_context_t *context) {
 }
 
 /**
- * @brief Verify firmware signature using ECDSA
+ * @brief Compute the digest the header signature covers
+ */
+void firmware_header_digest(const firmware_header_t *header, uint8_t *digest) {
+    sha256_context_t ctx;
+    const uint8_t *bytes = (const uint8_t *)header;
+    uint32_t tail = offsetof(firmware_header_t, signature) + sizeof(header->signature);
+    
+    /* Everything before and after the signature; hash binds in the image */
+    sha256_init(&ctx);
+    sha256_update(&ctx, bytes, offsetof(firmware_header_t, signature));
+    sha256_update(&ctx, bytes + tail, sizeof(firmware_header_t) - tail);
+    sha256_final(&ctx, digest);
+}
+
+/**
+ * @brief Check a computed image digest against the header and signature
  * 
- * In production, this would use the EFR32 Secure Vault cryptographic
- * accelerator for hardware-accelerated signature verification.
+ * Shared by the synchronous path and the overlapped boot, which hashes
+ * the image in a background job. The digest buffer is zeroized.
  */
-uint32_t verify_firmware_signature(const firmware_header_t *header, const uint8_t *image) {
+static uint32_t verify_firmware_digest(const firmware_header_t *header, uint8_t *digest) {
     volatile uint32_t verification_state = TOKEN_STATE_INVALID;
+    volatile uint32_t signature_state = ECDSA_VERIFY_INVALID;
+    volatile uint8_t diff = 0;
     
-    /* Inject jitter to desynchronize timing */
-    inject_random_jitter(get_trng_random());
+    /* Constant-time comparison against header hash */
+    for (int i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        diff |= (digest[i] ^ header->hash[i]);
+    }
     
-    /* In production: Use Secure Vault for ECDSA verification
-     * For demonstration, check basic header validity */
-    if (header->magic != 0x464D5750) { /* "FWPG" magic */
+    if (diff == 0) {
+        verification_state = TOKEN_STATE_LAYER1_OK;
+    } else {
+        memset(digest, 0, SHA256_DIGEST_SIZE);
         return TOKEN_STATE_INVALID;
     }
     
     inject_random_jitter(get_trng_random());
     
-    /* Verify image size is reasonable */
-    if (header->image_size == 0 || header->image_size > 0x100000) {
-        return TOKEN_STATE_INVALID;
+    /* Redundant comparison to defeat single glitch */
+    diff = 0;
+    for (int i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        diff |= (digest[i] ^ header->hash[i]);
     }
+    memset(digest, 0, SHA256_DIGEST_SIZE);
     
-    inject_random_jitter(get_trng_random());
+    if (diff != 0) {
+        return TOKEN_STATE_INVALID;
+    }
     
-    /* In production: Compute SHA-256 hash and verify ECDSA signature
-     * using Secure Vault cryptographic accelerator */
+    /* Segmented images: only what's needed to reach entry_point now,
+     * the rest on first access or in the background */
+    if (!image_merkle_verify_boot_segments(header)) {
+        return TOKEN_STATE_INVALID;
+    }
     
-    /* Simulate signature verification */
-    verification_state = TOKEN_STATE_LAYER1_OK;
+    /* ECDSA signature over the header digest by the root key: Secure
+     * Vault when it answers, flash comb tables otherwise (e.g. recovery) */
+    firmware_header_digest(header, digest);
+    signature_state = ecdsa_p256_verify(ECDSA_DEFAULT_BACKEND, digest, header->signature);
+    memset(digest, 0, SHA256_DIGEST_SIZE);
     
     inject_random_jitter(get_trng_random());
     
     /* Multi-stage verification to resist glitches */
-    if (verification_state == TOKEN_STATE_LAYER1_OK) {
+    if (verification_state == TOKEN_STATE_LAYER1_OK && signature_state == ECDSA_VERIFY_VALID) {
         verification_state = TOKEN_STATE_LAYER2_OK;
     } else {
         return TOKEN_STATE_INVALID;
@@ -169,7 +229,8 @@ uint32_t verify_firmware_signature(const firmware_header_t *header, const uint8_
     
     inject_random_jitter(get_trng_random());
     
-    if (verification_state == TOKEN_STATE_LAYER2_OK) {
+    /* Redundant check of the signature result */
+    if (verification_state == TOKEN_STATE_LAYER2_OK && (signature_state ^ ECDSA_VERIFY_VALID) == 0) {
         verification_state = TOKEN_STATE_ALL_VALID;
     } else {
         return TOKEN_STATE_INVALID;
@@ -178,10 +239,93 @@ uint32_t verify_firmware_signature(const firmware_header_t *header, const uint8_
     return verification_state;
 }
 
+/**
+ * @brief Verify firmware image hash and ECDSA signature
+ * 
+ * The image is streamed through the hash engine in chunks and compared
+ * against header->hash; the ECDSA P-256 signature over
+ * firmware_header_digest() is then checked against the root key (see
+ * ecdsa_p256.h).
+ */
+uint32_t verify_firmware_signature(const firmware_header_t *header, const uint8_t *image) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    
+    if (header == NULL || image == NULL) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    /* Inject jitter to desynchronize timing */
+    inject_random_jitter(get_trng_random());
+    
+    /* Check basic header validity */
+    if (header->magic != FIRMWARE_IMAGE_MAGIC) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    inject_random_jitter(get_trng_random());
+    
+    /* Verify image size is reasonable */
+    if (header->image_size == 0 || header->image_size > FIRMWARE_MAX_IMAGE_SIZE) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    inject_random_jitter(get_trng_random());
+    
+    /* Stream image through the hash engine (Merkle images: leaf table only) */
+    if (!firmware_image_digest(header, image, digest)) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    return verify_firmware_digest(header, digest);
+}
+
+/**
+ * @brief Advance the background image digest
+ * 
+ * Flat images go through the resumable hash. Merkle images only hash
+ * their leaf table, which is done in the first step; LZ4 images are
+ * decompressed and hashed in one pass once the SE is free. The SE mailbox
+ * serves one command at a time, so a pipelined hash is not started while
+ * the PUF reconstruction is still in flight.
+ */
+static boot_job_status_t boot_digest_step(void *ctx) {
+    boot_digest_job_t *job = (boot_digest_job_t *)ctx;
+    
+    if (!job->started) {
+        if (job->header->magic != FIRMWARE_IMAGE_MAGIC || job->header->image_size == 0 ||
+            job->header->image_size > FIRMWARE_MAX_IMAGE_SIZE) {
+            return BOOT_JOB_FAILED;
+        }
+        
+        if ((job->header->flags & FIRMWARE_FLAG_MERKLE) != 0) {
+            return firmware_image_digest(job->header, job->image, job->digest)
+                   ? BOOT_JOB_DONE : BOOT_JOB_FAILED;
+        }
+        
+        if (IMAGE_HASH_DEFAULT_BACKEND == IMAGE_HASH_BACKEND_SE_PIPELINED &&
+            g_puf_job.status == BOOT_JOB_PENDING) {
+            return BOOT_JOB_PENDING;
+        }
+        
+        if ((job->header->flags & FIRMWARE_FLAG_LZ4) != 0) {
+            return firmware_image_digest(job->header, job->image, job->digest)
+                   ? BOOT_JOB_DONE : BOOT_JOB_FAILED;
+        }
+        
+        if (!image_hash_begin(&job->hash, job->image, job->header->image_size,
+                              IMAGE_HASH_DEFAULT_BACKEND, job->digest)) {
+            return BOOT_JOB_FAILED;
+        }
+        job->started = true;
+    }
+    
+    return image_hash_step(&job->hash);
+}
+
 /**
  * @brief Check anti-rollback version
  */
-uint32_t check_anti_rollback(uint32_t new_version) {
+uint32_t check_anti_rollback(uint32_t new_version, uint32_t security_epoch) {
     version_t new_ver;
     rollback_status_t status;
     
@@ -192,6 +336,11 @@ uint32_t check_anti_rollback(uint32_t new_version) {
     
     inject_random_jitter(get_trng_random());
     
+    /* Security epoch: images older than the last security release are refused */
+    if (check_security_epoch(security_epoch) == ROLLBACK_CHECK_FAIL) {
+        return TOKEN_STATE_INVALID;
+    }
+    
     /* Check against OTP version */
     status = check_version_rollback(&new_ver);
     
@@ -200,8 +349,8 @@ uint32_t check_anti_rollback(uint32_t new_version) {
     /* Multi-stage verification */
     if (status == ROLLBACK_CHECK_PASS || status == ROLLBACK_VERSION_HIGHER) {
         inject_random_jitter(get_trng_random());
-        /* Redundant check */
-        status = check_version_rollback(&new_ver);
+        /* Redundant check against the complement mirror (no OTP re-read) */
+        status = check_version_rollback_mirror(&new_ver);
         if (status == ROLLBACK_CHECK_PASS || status == ROLLBACK_VERSION_HIGHER) {
             return TOKEN_STATE_ALL_VALID;
         }
@@ -223,6 +372,14 @@ boot_status_t secure_boot_init(void) {
     g_boot_context.verification_tokens[2] = TOKEN_LAYER_3;
     g_boot_context.verification_tokens[3] = TOKEN_LAYER_4;
     
+    /* Bulk-fill the entropy pool before the first jitter call */
+    if (!entropy_pool_init()) {
+        return BOOT_STATUS_FAILURE;
+    }
+    
+    /* Start a fresh jitter budget for this boot */
+    jitter_budget_reset();
+    
     /* Initialize random seed from TRNG */
     g_boot_context.random_jitter_seed = get_trng_random();
     
@@ -246,64 +403,271 @@ boot_status_t secure_boot_init(void) {
     return BOOT_STATUS_SUCCESS;
 }
 
+/**
+ * @brief Fail the boot once no background job still touches the hardware
+ */
+static boot_status_t secure_boot_abort(void) {
+    (void)boot_sched_join_all();
+    memset(g_digest_ctx.digest, 0, sizeof(g_digest_ctx.digest));
+    if (g_puf_job.status == BOOT_JOB_DONE) {
+        puf_session_close();
+    }
+    
+    g_boot_context.status = BOOT_STATUS_FAILURE;
+    BOOT_PROFILE_END(BOOT_PHASE_TOTAL);
+    
+    return BOOT_STATUS_FAILURE;
+}
+
 /**
  * @brief Execute secure boot sequence
+ * 
+ * PUF reconstruction, image hashing and IADC warmup are started as boot
+ * jobs and progress from every jitter call while the CPU runs the token
+ * and anti-rollback checks. All jobs are joined before the final decision.
+ * A WRITE_LOCK cache hit on a flat image is looked up first and never
+ * starts the hash.
  */
 boot_status_t execute_secure_boot(void) {
+    boot_status_t init_status;
     uint32_t token_result;
     uint32_t signature_result;
     uint32_t rollback_result;
+    bool signature_cached;
+    bool puf_session;
+    
+    BOOT_PROFILE_INIT();
+    BOOT_PROFILE_START(BOOT_PHASE_TOTAL);
     
     /* Initialize boot */
-    if (secure_boot_init() != BOOT_STATUS_SUCCESS) {
+    BOOT_PROFILE_START(BOOT_PHASE_INIT);
+    init_status = secure_boot_init();
+    BOOT_PROFILE_END(BOOT_PHASE_INIT);
+    
+    if (init_status != BOOT_STATUS_SUCCESS) {
+        BOOT_PROFILE_END(BOOT_PHASE_TOTAL);
         return BOOT_STATUS_FAILURE;
     }
     
     g_boot_context.status = BOOT_STATUS_VERIFYING;
     
+    /* Firmware header and image are read in place from the Non-Secure flash slot */
+    const firmware_header_t *fw_header = (const firmware_header_t *)FIRMWARE_SLOT_ADDRESS;
+    const uint8_t *fw_image = (const uint8_t *)(FIRMWARE_SLOT_ADDRESS + sizeof(firmware_header_t));
+    
+    /* Start the hardware-bound work; a failed submit leaves the job FAILED */
+    boot_sched_reset();
+    memset(&g_digest_ctx, 0, sizeof(g_digest_ctx));
+    g_digest_ctx.header = fw_header;
+    g_digest_ctx.image = fw_image;
+    (void)boot_sched_submit(&g_puf_job, puf_session_open_step, NULL);
+    (void)boot_sched_submit(&g_tamper_job, tamper_warmup_step, NULL);
+    
+    /* With WRITE_LOCK a cache hit vouches for the slot unhashed: look
+     * first (the MAC takes the PUF session) and only hash on a miss */
+    signature_result = TOKEN_STATE_INVALID;
+    if (!verify_cache_needs_digest(fw_header, VERIFY_CACHE_DEFAULT_MODE)) {
+        (void)boot_sched_join(&g_puf_job);
+        signature_result = verify_cache_check_digest(fw_header, NULL,
+                                                     VERIFY_CACHE_DEFAULT_MODE);
+    }
+    signature_cached = (signature_result == TOKEN_STATE_ALL_VALID);
+    if (!signature_cached) {
+        (void)boot_sched_submit(&g_digest_job, boot_digest_step, &g_digest_ctx);
+    }
+    
     inject_random_jitter(get_trng_random());
     
     /* Perform layered token verification */
+    BOOT_PROFILE_START(BOOT_PHASE_TOKENS);
     token_result = verify_layered_tokens(&g_boot_context);
+    BOOT_PROFILE_END(BOOT_PHASE_TOKENS);
     
     if (token_result != TOKEN_STATE_ALL_VALID) {
-        g_boot_context.status = BOOT_STATUS_FAILURE;
-        return BOOT_STATUS_FAILURE;
+        return secure_boot_abort();
     }
     
     inject_random_jitter(get_trng_random());
     
-    /* Simulate firmware header (in production, read from flash) */
-    firmware_header_t fw_header = {
-        .magic = 0x464D5750,
-        .version = 0x01000000,
-        .image_size = 0x10000,
-        .load_address = 0x08000000,
-        .entry_point = 0x08000400
-    };
+    /* Check anti-rollback (OTP only, so it runs while the image hashes) */
+    BOOT_PROFILE_START(BOOT_PHASE_ROLLBACK);
+    rollback_result = check_anti_rollback(fw_header->version,
+                                          FIRMWARE_SECURITY_EPOCH(fw_header->flags));
+    BOOT_PROFILE_END(BOOT_PHASE_ROLLBACK);
     
-    /* Verify firmware signature */
-    signature_result = verify_firmware_signature(&fw_header, NULL);
+    if (rollback_result != TOKEN_STATE_ALL_VALID) {
+        return secure_boot_abort();
+    }
+    
+    inject_random_jitter(get_trng_random());
+    
+    /* Verify firmware hash and signature, unless this exact image was
+     * fully verified on an earlier boot under the same OTP state */
+    BOOT_PROFILE_START(BOOT_PHASE_SIGNATURE);
+    if (!signature_cached) {
+        if (boot_sched_join(&g_digest_job) != BOOT_JOB_DONE) {
+            BOOT_PROFILE_END(BOOT_PHASE_SIGNATURE);
+            return secure_boot_abort();
+        }
+        if (verify_cache_needs_digest(fw_header, VERIFY_CACHE_DEFAULT_MODE)) {
+            signature_result = verify_cache_check_digest(fw_header, g_digest_ctx.digest,
+                                                         VERIFY_CACHE_DEFAULT_MODE);
+            signature_cached = (signature_result == TOKEN_STATE_ALL_VALID);
+        }
+        if (!signature_cached) {
+            signature_result = verify_firmware_digest(fw_header, g_digest_ctx.digest);
+        }
+        memset(g_digest_ctx.digest, 0, sizeof(g_digest_ctx.digest));
+    }
+    
+    /* A hit skips verify_firmware_digest(): open the boot segments here */
+    if (signature_cached && !image_merkle_verify_boot_segments(fw_header)) {
+        signature_result = TOKEN_STATE_INVALID;
+    }
+    BOOT_PROFILE_END(BOOT_PHASE_SIGNATURE);
     
     if (signature_result != TOKEN_STATE_ALL_VALID) {
-        g_boot_context.status = BOOT_STATUS_FAILURE;
-        return BOOT_STATUS_FAILURE;
+        return secure_boot_abort();
     }
     
     inject_random_jitter(get_trng_random());
     
-    /* Check anti-rollback */
-    rollback_result = check_anti_rollback(fw_header.version);
+    /* Nothing may still be in flight when the decision is taken. The PUF
+     * session only speeds up the cache MACs, so it is not required. */
+    puf_session = (boot_sched_join(&g_puf_job) == BOOT_JOB_DONE);
+    if (boot_sched_join(&g_tamper_job) != BOOT_JOB_DONE) {
+        return secure_boot_abort();
+    }
     
-    if (rollback_result != TOKEN_STATE_ALL_VALID) {
-        g_boot_context.status = BOOT_STATUS_FAILURE;
+    /* Raise the OTP epoch floor to this image's before caching it: the
+     * cache MAC binds the epoch. A no-op unless the epoch went up. */
+    if (!commit_security_epoch(FIRMWARE_SECURITY_EPOCH(fw_header->flags))) {
+        return secure_boot_abort();
+    }
+    
+    if (!signature_cached) {
+        /* Full verification passed: warm boots can take the fast path */
+        (void)verify_cache_store(fw_header, VERIFY_CACHE_DEFAULT_MODE);
+    } else if (VERIFY_CACHE_DEFAULT_MODE == VERIFY_CACHE_MODE_WRITE_LOCK &&
+               !verify_cache_lock_slot(fw_header)) {
+        /* Page locks clear on reset; without them the next boot can't trust the record */
+        verify_cache_invalidate();
+    }
+    
+    if (puf_session) {
+        puf_session_close();
+    }
+    
+    /* All verifications passed; record tamper activity seen so far */
+    g_boot_context.tamper_events = tamper_event_count();
+    g_boot_context.status = BOOT_STATUS_SUCCESS;
+    
+    BOOT_PROFILE_END(BOOT_PHASE_TOTAL);
+    
+    return BOOT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Copy the boot context of a completed boot
+ */
+bool secure_boot_get_context(boot_context_t *context) {
+    if (context == NULL || g_boot_context.status != BOOT_STATUS_SUCCESS) {
+        return false;
+    }
+    
+    memcpy(context, &g_boot_context, sizeof(boot_context_t));
+    
+    return true;
+}
+
+/**
+ * @brief Fail a warm resume; the caller falls back to execute_secure_boot()
+ */
+static boot_status_t secure_boot_resume_fail(void) {
+    g_boot_context.status = BOOT_STATUS_FAILURE;
+    BOOT_PROFILE_END(BOOT_PHASE_TOTAL);
+    
+    return BOOT_STATUS_FAILURE;
+}
+
+/**
+ * @brief Resume from a sealed boot context after EM4
+ * 
+ * The signature is not re-verified: the verified-image cache vouches for
+ * the slot under the restored OTP shadow. Tokens and anti-rollback are
+ * re-checked as on a full boot.
+ */
+boot_status_t secure_boot_resume(const boot_context_t *context,
+                                 const firmware_header_t *header, const uint8_t *image) {
+    uint32_t token_result;
+    uint32_t rollback_result;
+    uint32_t cache_result;
+    
+    if (context == NULL || header == NULL || image == NULL) {
         return BOOT_STATUS_FAILURE;
     }
     
+    /* Only a clean, completed boot may be resumed */
+    if (context->status != BOOT_STATUS_SUCCESS || context->tamper_events != 0) {
+        return BOOT_STATUS_FAILURE;
+    }
+    
+    BOOT_PROFILE_INIT();
+    BOOT_PROFILE_START(BOOT_PHASE_TOTAL);
+    
+    if (!entropy_pool_init()) {
+        return secure_boot_resume_fail();
+    }
+    jitter_budget_reset();
+    
+    memcpy(&g_boot_context, context, sizeof(boot_context_t));
+    g_boot_context.random_jitter_seed = get_trng_random();
+    g_boot_context.status = BOOT_STATUS_VERIFYING;
+    g_boot_context.boot_count++;
+    
+    inject_random_jitter(g_boot_context.random_jitter_seed);
+    
+    BOOT_PROFILE_START(BOOT_PHASE_TOKENS);
+    token_result = verify_layered_tokens(&g_boot_context);
+    BOOT_PROFILE_END(BOOT_PHASE_TOKENS);
+    
+    if (token_result != TOKEN_STATE_ALL_VALID) {
+        return secure_boot_resume_fail();
+    }
+    
+    BOOT_PROFILE_START(BOOT_PHASE_ROLLBACK);
+    rollback_result = check_anti_rollback(header->version,
+                                          FIRMWARE_SECURITY_EPOCH(header->flags));
+    BOOT_PROFILE_END(BOOT_PHASE_ROLLBACK);
+    
+    if (rollback_result != TOKEN_STATE_ALL_VALID) {
+        return secure_boot_resume_fail();
+    }
+    
     inject_random_jitter(get_trng_random());
     
-    /* All verifications passed */
+    /* Same image as the last full verification (MAC only with WRITE_LOCK,
+     * except that LZ4 images are decompressed and Merkle leaves rehashed) */
+    BOOT_PROFILE_START(BOOT_PHASE_SIGNATURE);
+    cache_result = verify_cache_check(header, image, VERIFY_CACHE_DEFAULT_MODE);
+    BOOT_PROFILE_END(BOOT_PHASE_SIGNATURE);
+    
+    if (cache_result != TOKEN_STATE_ALL_VALID ||
+        !image_merkle_verify_boot_segments(header)) {
+        return secure_boot_resume_fail();
+    }
+    
+    /* EM4 wakeup clears the page locks like a reset does */
+    if (VERIFY_CACHE_DEFAULT_MODE == VERIFY_CACHE_MODE_WRITE_LOCK &&
+        !verify_cache_lock_slot(header)) {
+        verify_cache_invalidate();
+        return secure_boot_resume_fail();
+    }
+    
+    g_boot_context.tamper_events = tamper_event_count();
     g_boot_context.status = BOOT_STATUS_SUCCESS;
     
+    BOOT_PROFILE_END(BOOT_PHASE_TOTAL);
+    
     return BOOT_STATUS_SUCCESS;
 }
@@ -0,0 +1,272 @@
+/**
+ * @file verify_cache.c
+ * @brief Verified-Image Cache Implementation
+ * 
+ * The MAC key is derived from the PUF on every use and never stored, so a
+ * record copied to another device, or forged without the PUF, never
+ * matches. The OTP version and security epoch are bound into the MAC:
+ * committing a new rollback floor invalidates the record implicitly.
+ */
+
+#include "verify_cache.h"
+#include "anti_rollback.h"
+#include "hmac_sha256.h"
+#include "image_merkle.h"
+#include "puf.h"
+#include "zeroize.h"
+#include <string.h>
+#if defined(SIM_PERIPH_MOCK)
+#include "mock_periph.h"
+#endif
+
+/* KDF context for the cache MAC key */
+static const uint8_t k_cache_kdf_context[] = "verify-cache-mac-v1";
+
+/* Secure storage for the cache record (in production, a Secure flash page
+ * rewritten through the MSC; survives reset) */
+static verify_cache_record_t g_cache_record;
+
+/* Simulated MSC page lock bits (in production, MSC->PAGELOCK0..12) */
+static volatile uint32_t MSC_PAGELOCK[VERIFY_CACHE_LOCK_WORDS];
+
+/* Address of flash page 0 (main flash starts at 0 on EFR32 Series 2) */
+#if defined(SIM_PERIPH_MOCK)
+#define MSC_FLASH_BASE  (g_mock_periph.flash_base)
+#else
+#define MSC_FLASH_BASE  ((uintptr_t)0)
+#endif
+
+/**
+ * @brief HMAC-SHA256 over the cached state
+ */
+static bool verify_cache_mac(const firmware_header_t *header, uint32_t mode,
+                             uint8_t mac[VERIFY_CACHE_MAC_SIZE]) {
+    uint8_t key[PUF_KEY_SIZE];
+    version_t version;
+    uint32_t epoch;
+    bool ok;
+    
+    /* Rollback state bound into the MAC */
+    if (!read_otp_version(&version) || !read_otp_counter(OTP_EPOCH_COUNTER, &epoch)) {
+        return false;
+    }
+    
+    uint32_t state[3] = {
+        ((uint32_t)version.major << 24) | ((uint32_t)version.minor << 16) | version.patch,
+        epoch,
+        mode
+    };
+    
+    if (!puf_derive_key(k_cache_kdf_context, sizeof(k_cache_kdf_context) - 1,
+                        key, sizeof(key))) {
+        return false;
+    }
+    
+    /* Header carries the image hash */
+    const hmac_sha256_part_t parts[] = {
+        { header, sizeof(firmware_header_t) },
+        { state, sizeof(state) }
+    };
+    ok = hmac_sha256(key, sizeof(key), parts, sizeof(parts) / sizeof(parts[0]),
+                     mac, VERIFY_CACHE_MAC_SIZE);
+    
+    secure_zeroize(key, sizeof(key));
+    
+    return ok;
+}
+
+/**
+ * @brief Constant-time compare against the stored MAC
+ */
+static uint8_t verify_cache_mac_diff(const uint8_t *mac) {
+    volatile uint8_t diff = 0;
+    
+    for (uint32_t i = 0; i < VERIFY_CACHE_MAC_SIZE; i++) {
+        diff |= mac[i] ^ g_cache_record.mac[i];
+    }
+    
+    return diff;
+}
+
+/**
+ * @brief Write-lock every flash page of the header and image
+ */
+bool verify_cache_lock_slot(const firmware_header_t *header) {
+    if (header == NULL) {
+        return false;
+    }
+    
+    /* Stored extent: descriptors, leaf table or compressed stream included */
+    uint32_t stored = firmware_image_stored_size(header, (const uint8_t *)(header + 1));
+    if (stored == 0) {
+        return false;
+    }
+    
+    /* Offset into main flash; an address below it wraps out of range */
+    uintptr_t start = (uintptr_t)header - MSC_FLASH_BASE;
+    uintptr_t end = start + sizeof(firmware_header_t) + stored;
+    uintptr_t last = (end - 1) / VERIFY_CACHE_PAGE_SIZE;
+    uint32_t first = (uint32_t)(start / VERIFY_CACHE_PAGE_SIZE);
+    
+    if (end < start || last >= VERIFY_CACHE_LOCK_WORDS * 32) {
+        return false;  /* Outside the lockable range */
+    }
+    
+    /* In production: MSC->PAGELOCKn |= bit, then read back */
+    for (uint32_t page = first; page <= last; page++) {
+        MSC_PAGELOCK[page / 32] |= 1UL << (page % 32);
+    }
+    
+    for (uint32_t page = first; page <= last; page++) {
+        if ((MSC_PAGELOCK[page / 32] & (1UL << (page % 32))) == 0) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Check whether a cache check needs the image digest
+ */
+bool verify_cache_needs_digest(const firmware_header_t *header, verify_cache_mode_t mode) {
+    /* LZ4 images run from RAM at load_address, lost on reset and in EM4:
+     * the digest pass is also what decompresses them there. For Merkle
+     * images it copies and arms the leaf table that segment faults are
+     * resolved against (hashing the leaves only, not the image) */
+    if (header == NULL || (header->flags & (FIRMWARE_FLAG_LZ4 | FIRMWARE_FLAG_MERKLE)) != 0) {
+        return true;
+    }
+    
+    /* With WRITE_LOCK the slot was locked for the whole previous run and
+     * every Secure write invalidated the record, so the hash still holds */
+    return mode != VERIFY_CACHE_MODE_WRITE_LOCK;
+}
+
+/**
+ * @brief Check whether the image was verified on a previous boot
+ */
+uint32_t verify_cache_check(const firmware_header_t *header, const uint8_t *image,
+                            verify_cache_mode_t mode) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint32_t result;
+    
+    if (header == NULL || image == NULL || g_cache_record.magic != VERIFY_CACHE_MAGIC) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    if (!verify_cache_needs_digest(header, mode)) {
+        return verify_cache_check_digest(header, NULL, mode);
+    }
+    
+    if (header->magic != FIRMWARE_IMAGE_MAGIC || header->image_size == 0 ||
+        header->image_size > FIRMWARE_MAX_IMAGE_SIZE ||
+        !firmware_image_digest(header, image, digest)) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    result = verify_cache_check_digest(header, digest, mode);
+    memset(digest, 0, sizeof(digest));
+    
+    return result;
+}
+
+/**
+ * @brief Check the cache against an image digest the caller already computed
+ */
+uint32_t verify_cache_check_digest(const firmware_header_t *header, const uint8_t *digest,
+                                   verify_cache_mode_t mode) {
+    volatile uint32_t state = TOKEN_STATE_INVALID;
+    uint8_t mac[VERIFY_CACHE_MAC_SIZE];
+    volatile uint8_t diff = 0;
+    
+    if (header == NULL || g_cache_record.magic != VERIFY_CACHE_MAGIC) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    /* A record only serves the mode it was written for */
+    if (g_cache_record.mode != (uint32_t)mode || header->magic != FIRMWARE_IMAGE_MAGIC ||
+        header->image_size == 0 || header->image_size > FIRMWARE_MAX_IMAGE_SIZE) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    if (verify_cache_needs_digest(header, mode)) {
+        if (digest == NULL) {
+            return TOKEN_STATE_INVALID;
+        }
+        
+        /* Image must still match the hash the signature covered */
+        for (uint32_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+            diff |= digest[i] ^ header->hash[i];
+        }
+        if (diff != 0) {
+            return TOKEN_STATE_INVALID;
+        }
+        
+        /* Segmented images still verify their boot segments eagerly */
+        if (!image_merkle_verify_boot_segments(header)) {
+            return TOKEN_STATE_INVALID;
+        }
+    }
+    
+    state = TOKEN_STATE_LAYER1_OK;
+    
+    if (!verify_cache_mac(header, (uint32_t)mode, mac)) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    if (verify_cache_mac_diff(mac) == 0 && state == TOKEN_STATE_LAYER1_OK) {
+        state = TOKEN_STATE_LAYER2_OK;
+    } else {
+        verify_cache_invalidate();  /* Stale or forged: force full verify */
+        return TOKEN_STATE_INVALID;
+    }
+    
+    /* Redundant comparison to defeat single glitch */
+    if (verify_cache_mac_diff(mac) == 0 && state == TOKEN_STATE_LAYER2_OK) {
+        state = TOKEN_STATE_ALL_VALID;
+    } else {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    secure_zeroize(mac, sizeof(mac));
+    
+    return state;
+}
+
+/**
+ * @brief Record a fully verified image
+ */
+bool verify_cache_store(const firmware_header_t *header, verify_cache_mode_t mode) {
+    verify_cache_record_t record;
+    
+    if (header == NULL) {
+        return false;
+    }
+    
+    if (mode == VERIFY_CACHE_MODE_WRITE_LOCK && !verify_cache_lock_slot(header)) {
+        return false;  /* Lock must be in place before it can be trusted */
+    }
+    
+    if (!verify_cache_mac(header, (uint32_t)mode, record.mac)) {
+        return false;
+    }
+    
+    record.magic = VERIFY_CACHE_MAGIC;
+    record.mode = (uint32_t)mode;
+    
+    /* In production: erase and program the cache page through the MSC */
+    memcpy(&g_cache_record, &record, sizeof(record));
+    secure_zeroize((uint8_t *)&record, sizeof(record));
+    
+    return true;
+}
+
+/**
+ * @brief Invalidate the cache
+ */
+void verify_cache_invalidate(void) {
+    /* In production: clear the magic word (one 0-bit write, no erase) */
+    g_cache_record.magic = 0;
+    memset(g_cache_record.mac, 0, sizeof(g_cache_record.mac));
+}
@@ -0,0 +1,262 @@
+/**
+ * @file warm_resume.c
+ * @brief EM4 Warm Resume Implementation
+ * 
+ * The MAC key is derived from the PUF on every use, so a snapshot is
+ * only accepted by the device that sealed it. The firmware header is
+ * bound into the MAC; whether the image itself is unchanged is left to
+ * the verified-image cache, checked by secure_boot_resume(). Nothing is
+ * restored until the snapshot has been authenticated.
+ */
+
+#include "warm_resume.h"
+#include "tamper_detection.h"
+#include "puf.h"
+#include "hmac_sha256.h"
+#include "zeroize.h"
+#include <stddef.h>
+#include <string.h>
+
+#define WARM_RESUME_WORDS   (sizeof(warm_resume_snapshot_t) / sizeof(uint32_t))
+#define WARM_RESUME_RNR_MASK    (SAU_REGION_ALIGN - 1U)
+
+/* The snapshot must fit the BURAM words left after the tamper record */
+typedef char warm_resume_fits_buram[(sizeof(warm_resume_snapshot_t) <=
+                                     WARM_RESUME_BURAM_WORDS * sizeof(uint32_t)) ? 1 : -1];
+
+/* KDF context for the snapshot MAC key */
+static const uint8_t k_resume_kdf_context[] = "warm-resume-mac-v1";
+
+/* Simulated BURAM words (in production, BURAM->RET[WARM_RESUME_BURAM_FIRST + n].REG,
+ * made Secure-only through the SMU so Non-Secure code cannot replay it) */
+static volatile uint32_t BURAM_RESUME[WARM_RESUME_WORDS];
+
+/**
+ * @brief HMAC-SHA256 over the sealed fields and the firmware header
+ */
+static bool warm_resume_mac(const warm_resume_snapshot_t *snapshot,
+                            const firmware_header_t *header,
+                            uint8_t mac[WARM_RESUME_MAC_SIZE]) {
+    uint8_t key[PUF_KEY_SIZE];
+    bool ok;
+    
+    if (!puf_derive_key(k_resume_kdf_context, sizeof(k_resume_kdf_context) - 1,
+                        key, sizeof(key))) {
+        return false;
+    }
+    
+    /* Snapshot up to the MAC, then the header it was sealed against */
+    const hmac_sha256_part_t parts[] = {
+        { snapshot, offsetof(warm_resume_snapshot_t, mac) },
+        { header, sizeof(firmware_header_t) }
+    };
+    ok = hmac_sha256(key, sizeof(key), parts, sizeof(parts) / sizeof(parts[0]),
+                     mac, WARM_RESUME_MAC_SIZE);
+    
+    secure_zeroize(key, sizeof(key));
+    
+    return ok;
+}
+
+/**
+ * @brief Constant-time compare of two MACs
+ */
+static uint8_t warm_resume_mac_diff(const uint8_t *a, const uint8_t *b) {
+    volatile uint8_t diff = 0;
+    
+    for (uint32_t i = 0; i < WARM_RESUME_MAC_SIZE; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    
+    return diff;
+}
+
+/**
+ * @brief Seal the running state into BURAM
+ */
+bool warm_resume_seal(const firmware_header_t *header) {
+    warm_resume_snapshot_t snapshot;
+    const sau_region_words_t *words = NULL;
+    tamper_record_t record;
+    const uint32_t *src;
+    uint32_t sau_count;
+    
+    warm_resume_invalidate();
+    
+    if (header == NULL || tamper_get_last_record(&record)) {
+        return false;
+    }
+    
+    memset(&snapshot, 0, sizeof(snapshot));
+    
+    if (!secure_boot_get_context(&snapshot.context)) {
+        return false;
+    }
+    
+    /* Events latched after the boot completed count too */
+    snapshot.context.tamper_events = tamper_event_count();
+    if (snapshot.context.tamper_events != 0) {
+        return false;
+    }
+    
+    /* Only the precomputed blob can be sealed; it is what the wakeup applies */
+    sau_count = trustzone_get_sau_words(&words);
+    if (sau_count == 0 || sau_count > WARM_RESUME_SAU_MAX) {
+        return false;
+    }
+    for (uint32_t i = 0; i < sau_count; i++) {
+        if (words[i].rnr >= SAU_REGION_MAX || (words[i].rbar & WARM_RESUME_RNR_MASK) != 0) {
+            return false;
+        }
+        snapshot.sau[i].rbar_rnr = words[i].rbar | words[i].rnr;
+        snapshot.sau[i].rlar = words[i].rlar;
+    }
+    
+    if (!anti_rollback_export_shadow(snapshot.otp_shadow, ANTI_ROLLBACK_SHADOW_WORDS)) {
+        return false;
+    }
+    
+    snapshot.magic = WARM_RESUME_MAGIC | sau_count;
+    
+    if (!warm_resume_mac(&snapshot, header, snapshot.mac)) {
+        return false;
+    }
+    
+    /* In production: BURAM->RET[n].REG; magic last so a torn seal never validates */
+    src = (const uint32_t *)&snapshot;
+    for (uint32_t i = 1; i < WARM_RESUME_WORDS; i++) {
+        BURAM_RESUME[i] = src[i];
+    }
+    BURAM_RESUME[0] = src[0];
+    
+    secure_zeroize((uint8_t *)&snapshot, sizeof(snapshot));
+    
+    return true;
+}
+
+/**
+ * @brief Authenticate the snapshot, then restore it
+ */
+static uint32_t warm_resume_apply(const warm_resume_snapshot_t *snapshot,
+                                  const trustzone_config_t *tz_config,
+                                  const firmware_header_t *header, const uint8_t *image) {
+    volatile uint32_t state = TOKEN_STATE_INVALID;
+    sau_region_words_t words[WARM_RESUME_SAU_MAX];
+    uint8_t mac[WARM_RESUME_MAC_SIZE];
+    uint32_t sau_count = snapshot->magic & ~WARM_RESUME_MAGIC_MASK;
+    
+    if ((snapshot->magic & WARM_RESUME_MAGIC_MASK) != WARM_RESUME_MAGIC ||
+        sau_count == 0 || sau_count > WARM_RESUME_SAU_MAX) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    state = TOKEN_STATE_LAYER1_OK;
+    
+    if (!warm_resume_mac(snapshot, header, mac)) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    if (warm_resume_mac_diff(mac, snapshot->mac) == 0 && state == TOKEN_STATE_LAYER1_OK) {
+        state = TOKEN_STATE_LAYER2_OK;
+    } else {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    /* Redundant comparison to defeat single glitch */
+    if (warm_resume_mac_diff(mac, snapshot->mac) != 0 || state != TOKEN_STATE_LAYER2_OK) {
+        return TOKEN_STATE_INVALID;
+    }
+    secure_zeroize(mac, sizeof(mac));
+    
+    /* Authentic from here on: shadow first, the boot decision reads it */
+    if (!anti_rollback_resume(snapshot->otp_shadow, ANTI_ROLLBACK_SHADOW_WORDS)) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    if (secure_boot_resume(&snapshot->context, header, image) != BOOT_STATUS_SUCCESS) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    /* SAU partition of the sealed run, then the RAM-only TrustZone state */
+    for (uint32_t i = 0; i < sau_count; i++) {
+        words[i].rnr = snapshot->sau[i].rbar_rnr & WARM_RESUME_RNR_MASK;
+        words[i].rbar = snapshot->sau[i].rbar_rnr & ~WARM_RESUME_RNR_MASK;
+        words[i].rlar = snapshot->sau[i].rlar;
+    }
+    if (!sau_apply_words(words, sau_count) || !sau_enable() ||
+        !trustzone_resume(tz_config)) {
+        return TOKEN_STATE_INVALID;
+    }
+    
+    if (state == TOKEN_STATE_LAYER2_OK) {
+        state = TOKEN_STATE_ALL_VALID;
+    }
+    
+    return state;
+}
+
+/**
+ * @brief Check and restore a sealed snapshot after EM4 wakeup
+ */
+uint32_t warm_resume_restore(const trustzone_config_t *tz_config,
+                             const firmware_header_t *header, const uint8_t *image) {
+    warm_resume_snapshot_t snapshot;
+    uint32_t *dst = (uint32_t *)&snapshot;
+    tamper_record_t record;
+    uint32_t result;
+    bool puf_session;
+    
+    /* Single use: a failed or replayed snapshot never gets a second try */
+    for (uint32_t i = 0; i < WARM_RESUME_WORDS; i++) {
+        dst[i] = BURAM_RESUME[i];
+    }
+    warm_resume_invalidate();
+    
+    /* A tamper response since sealing always takes the full boot */
+    if (tz_config == NULL || header == NULL || image == NULL ||
+        tamper_get_last_record(&record)) {
+        secure_zeroize((uint8_t *)&snapshot, sizeof(snapshot));
+        return TOKEN_STATE_INVALID;
+    }
+    
+    /* One PUF reconstruction for both the snapshot and the cache MAC */
+    puf_session = puf_session_open();
+    
+    result = warm_resume_apply(&snapshot, tz_config, header, image);
+    
+    if (puf_session) {
+        puf_session_close();
+    }
+    secure_zeroize((uint8_t *)&snapshot, sizeof(snapshot));
+    
+    return result;
+}
+
+/**
+ * @brief Discard any sealed snapshot
+ */
+void warm_resume_invalidate(void) {
+    for (uint32_t i = 0; i < WARM_RESUME_WORDS; i++) {
+        BURAM_RESUME[i] = 0;
+    }
+}
+
+/**
+ * @brief Seal the snapshot and enter EM4
+ */
+void warm_resume_enter_em4(const firmware_header_t *header) {
+    /* A failed seal leaves BURAM cleared, so the wakeup boots in full */
+    (void)warm_resume_seal(header);
+    
+    /* RAM is lost in EM4; drop the TrustZone state trustzone_resume() rebuilds */
+    trustzone_suspend();
+    
+    /* EM4: everything but BURAM/BURTC off until a wakeup pin or BURTC
+     * event; wakeup starts from the reset vector.
+     * In production:
+     * SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+     * for (i = 0; i < 4; i++) { EMU->EM4CTRL = EM4ENTRY(2); EMU->EM4CTRL = EM4ENTRY(3); }
+     * EMU->EM4CTRL = EM4ENTRY(2);
+     * __WFI();
+     */
+}
@@ -0,0 +1,507 @@
+/**
+ * @file ecdsa_p256.c
+ * @brief ECDSA P-256 Firmware Signature Verification Implementation
+ * 
+ * Software backend: 8 x 32-bit limb Montgomery arithmetic (CIOS) for both
+ * the field and the group order, Jacobian coordinates with a = -3, and a
+ * two-table interleaved comb so u1*G + u2*Q costs one doubling and up to
+ * two mixed additions per comb column. The final x-coordinate check is
+ * done projectively (r * Z^2 == X), so no field inversion is needed.
+ * Verification only handles public data and is not constant time.
+ */
+
+#include "ecdsa_p256.h"
+#include "boot_profile.h"
+#include "ramfunc.h"
+#include <stddef.h>
+#include <string.h>
+#if defined(SIM_PERIPH_MOCK)
+#include "mock_periph.h"
+#endif
+
+#define P256_LIMBS          8
+#define COMB_SPACING        ((256 + ECDSA_COMB_TEETH - 1) / ECDSA_COMB_TEETH)
+
+/* SE mailbox status (in production, SEMAILBOX_HOST->RX_STATUS / SE version query) */
+#define SE_STATUS_READY     (1UL << 0)
+#if defined(SIM_PERIPH_MOCK)
+#define SEMAILBOX_STATUS    (g_mock_periph.semailbox_status)
+#else
+static volatile uint32_t SEMAILBOX_STATUS = SE_STATUS_READY;
+#endif
+
+typedef uint32_t p256_int_t[P256_LIMBS];
+
+/* Jacobian point; Z == 0 is the point at infinity */
+typedef struct {
+    p256_int_t x;
+    p256_int_t y;
+    p256_int_t z;
+} p256_point_t;
+
+/* Modulus with its Montgomery constants */
+typedef struct {
+    p256_int_t m;
+    p256_int_t rr;               /* 2^512 mod m */
+    uint32_t m0inv;              /* -m^-1 mod 2^32 */
+} p256_modulus_t;
+
+static const p256_modulus_t k_p256_p = {
+    { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000,
+      0x00000000, 0x00000000, 0x00000001, 0xFFFFFFFF },
+    { 0x00000003, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFB,
+      0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFD, 0x00000004 },
+    0x00000001
+};
+
+static const p256_modulus_t k_p256_n = {
+    { 0xFC632551, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD,
+      0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF },
+    { 0xBE79EEA2, 0x83244C95, 0x49BD6FA6, 0x4699799C,
+      0x2B6BEC59, 0x2845B239, 0xF3D95620, 0x66E12D94 },
+    0xEE00BC4F
+};
+
+/* n - 2 (Fermat inversion exponent) */
+static const p256_int_t k_p256_n_minus_2 = {
+    0xFC63254F, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD,
+    0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF
+};
+
+/* 2^256 mod p (1 in the Montgomery domain) */
+static const p256_int_t k_p256_one = {
+    0x00000001, 0x00000000, 0x00000000, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFE, 0x00000000
+};
+
+static ecdsa_stats_t g_ecdsa_stats[ECDSA_BACKEND_COUNT];
+
+/**
+ * @brief Load a 32-byte big-endian integer
+ */
+static void p256_from_bytes(p256_int_t r, const uint8_t *in) {
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        const uint8_t *b = &in[(P256_LIMBS - 1 - i) * 4];
+        r[i] = ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) |
+               ((uint32_t)b[2] << 8) | (uint32_t)b[3];
+    }
+}
+
+static bool p256_is_zero(const p256_int_t a) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        acc |= a[i];
+    }
+    return acc == 0;
+}
+
+static bool p256_equal(const p256_int_t a, const p256_int_t b) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        acc |= a[i] ^ b[i];
+    }
+    return acc == 0;
+}
+
+/**
+ * @brief r = a - b, returns the borrow
+ */
+static uint32_t p256_sub_raw(p256_int_t r, const p256_int_t a, const p256_int_t b) {
+    int64_t t = 0;
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        t += (int64_t)a[i] - b[i];
+        r[i] = (uint32_t)t;
+        t >>= 32;
+    }
+    return (uint32_t)(t & 1);
+}
+
+/**
+ * @brief r = a + b, returns the carry
+ */
+static uint32_t p256_add_raw(p256_int_t r, const p256_int_t a, const p256_int_t b) {
+    uint64_t t = 0;
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        t += (uint64_t)a[i] + b[i];
+        r[i] = (uint32_t)t;
+        t >>= 32;
+    }
+    return (uint32_t)t;
+}
+
+/**
+ * @brief Check a < m
+ */
+static bool p256_less(const p256_int_t a, const p256_int_t m) {
+    p256_int_t t;
+    return p256_sub_raw(t, a, m) != 0;
+}
+
+/**
+ * @brief r = a + b mod m (a, b < m)
+ */
+static void p256_mod_add(p256_int_t r, const p256_int_t a, const p256_int_t b,
+                         const p256_modulus_t *mod) {
+    p256_int_t t;
+    uint32_t carry = p256_add_raw(r, a, b);
+    uint32_t borrow = p256_sub_raw(t, r, mod->m);
+    
+    if (carry != 0 || borrow == 0) {
+        memcpy(r, t, sizeof(t));
+    }
+}
+
+/**
+ * @brief r = a - b mod m (a, b < m)
+ */
+static void p256_mod_sub(p256_int_t r, const p256_int_t a, const p256_int_t b,
+                         const p256_modulus_t *mod) {
+    if (p256_sub_raw(r, a, b) != 0) {
+        (void)p256_add_raw(r, r, mod->m);
+    }
+}
+
+/**
+ * @brief r = a * b * 2^-256 mod m (CIOS; a, b < m)
+ */
+RAMFUNC static void p256_mont_mul(p256_int_t r, const p256_int_t a, const p256_int_t b,
+                          const p256_modulus_t *mod) {
+    uint32_t t[P256_LIMBS + 2] = {0};
+    
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        uint64_t c = 0;
+        
+        for (uint32_t j = 0; j < P256_LIMBS; j++) {
+            c += (uint64_t)t[j] + (uint64_t)a[j] * b[i];
+            t[j] = (uint32_t)c;
+            c >>= 32;
+        }
+        c += t[P256_LIMBS];
+        t[P256_LIMBS] = (uint32_t)c;
+        t[P256_LIMBS + 1] = (uint32_t)(c >> 32);
+        
+        uint32_t q = t[0] * mod->m0inv;
+        c = (uint64_t)t[0] + (uint64_t)q * mod->m[0];
+        c >>= 32;
+        for (uint32_t j = 1; j < P256_LIMBS; j++) {
+            c += (uint64_t)t[j] + (uint64_t)q * mod->m[j];
+            t[j - 1] = (uint32_t)c;
+            c >>= 32;
+        }
+        c += t[P256_LIMBS];
+        t[P256_LIMBS - 1] = (uint32_t)c;
+        t[P256_LIMBS] = t[P256_LIMBS + 1] + (uint32_t)(c >> 32);
+    }
+    
+    /* Result < 2m: one conditional subtraction */
+    p256_int_t s;
+    uint32_t borrow = p256_sub_raw(s, t, mod->m);
+    if (t[P256_LIMBS] != 0 || borrow == 0) {
+        memcpy(r, s, sizeof(s));
+    } else {
+        memcpy(r, t, sizeof(s));
+    }
+}
+
+RAMFUNC static void p256_mont_sqr(p256_int_t r, const p256_int_t a, const p256_modulus_t *mod) {
+    p256_mont_mul(r, a, a, mod);
+}
+
+/**
+ * @brief r = a^-1 * 2^256 mod n, from a in the Montgomery domain
+ */
+static void p256_scalar_inv(p256_int_t r, const p256_int_t a) {
+    p256_int_t acc;
+    
+    /* Montgomery one: 2^512 * 2^-256 */
+    static const p256_int_t one = {1, 0, 0, 0, 0, 0, 0, 0};
+    p256_mont_mul(acc, one, k_p256_n.rr, &k_p256_n);
+    
+    for (int32_t bit = 255; bit >= 0; bit--) {
+        p256_mont_sqr(acc, acc, &k_p256_n);
+        if ((k_p256_n_minus_2[bit >> 5] >> (bit & 31)) & 1) {
+            p256_mont_mul(acc, acc, a, &k_p256_n);
+        }
+    }
+    
+    memcpy(r, acc, sizeof(acc));
+}
+
+/**
+ * @brief Point doubling, a = -3 (dbl-2001-b)
+ */
+static void p256_point_double(p256_point_t *r, const p256_point_t *a) {
+    const p256_modulus_t *p = &k_p256_p;
+    p256_int_t delta, gamma, beta, alpha, t1, t2;
+    
+    if (p256_is_zero(a->z)) {
+        *r = *a;
+        return;
+    }
+    
+    p256_mont_sqr(delta, a->z, p);
+    p256_mont_sqr(gamma, a->y, p);
+    p256_mont_mul(beta, a->x, gamma, p);
+    
+    /* alpha = 3 * (X - delta) * (X + delta) */
+    p256_mod_sub(t1, a->x, delta, p);
+    p256_mod_add(t2, a->x, delta, p);
+    p256_mont_mul(alpha, t1, t2, p);
+    p256_mod_add(t1, alpha, alpha, p);
+    p256_mod_add(alpha, t1, alpha, p);
+    
+    /* Z3 = (Y + Z)^2 - gamma - delta */
+    p256_mod_add(t1, a->y, a->z, p);
+    p256_mont_sqr(t1, t1, p);
+    p256_mod_sub(t1, t1, gamma, p);
+    p256_mod_sub(r->z, t1, delta, p);
+    
+    /* X3 = alpha^2 - 8 * beta */
+    p256_mod_add(beta, beta, beta, p);
+    p256_mod_add(beta, beta, beta, p);          /* 4 * beta */
+    p256_mont_sqr(t1, alpha, p);
+    p256_mod_add(t2, beta, beta, p);
+    p256_mod_sub(r->x, t1, t2, p);
+    
+    /* Y3 = alpha * (4 * beta - X3) - 8 * gamma^2 */
+    p256_mod_sub(t1, beta, r->x, p);
+    p256_mont_mul(t1, alpha, t1, p);
+    p256_mont_sqr(gamma, gamma, p);
+    p256_mod_add(gamma, gamma, gamma, p);
+    p256_mod_add(gamma, gamma, gamma, p);
+    p256_mod_add(gamma, gamma, gamma, p);
+    p256_mod_sub(r->y, t1, gamma, p);
+}
+
+/**
+ * @brief Mixed addition r = a + b, b affine (madd-2007-bl)
+ */
+static void p256_point_add_affine(p256_point_t *r, const p256_point_t *a,
+                                  const ecdsa_comb_point_t *b) {
+    const p256_modulus_t *p = &k_p256_p;
+    p256_int_t z1z1, u2, s2, h, hh, i, j, rr, v, t;
+    
+    if (p256_is_zero(a->z)) {
+        memcpy(r->x, b->x, sizeof(r->x));
+        memcpy(r->y, b->y, sizeof(r->y));
+        memcpy(r->z, k_p256_one, sizeof(r->z));
+        return;
+    }
+    
+    p256_mont_sqr(z1z1, a->z, p);
+    p256_mont_mul(u2, b->x, z1z1, p);
+    p256_mont_mul(s2, b->y, a->z, p);
+    p256_mont_mul(s2, s2, z1z1, p);
+    
+    p256_mod_sub(h, u2, a->x, p);
+    p256_mod_sub(rr, s2, a->y, p);
+    
+    if (p256_is_zero(h)) {
+        if (p256_is_zero(rr)) {
+            p256_point_double(r, a);      /* a == b */
+        } else {
+            memset(r, 0, sizeof(*r));     /* a == -b */
+        }
+        return;
+    }
+    
+    p256_mod_add(rr, rr, rr, p);
+    p256_mont_sqr(hh, h, p);
+    p256_mod_add(i, hh, hh, p);
+    p256_mod_add(i, i, i, p);
+    p256_mont_mul(j, h, i, p);
+    p256_mont_mul(v, a->x, i, p);
+    
+    /* Z3 = (Z1 + H)^2 - Z1Z1 - HH (before a->z may be overwritten) */
+    p256_mod_add(t, a->z, h, p);
+    p256_mont_sqr(t, t, p);
+    p256_mod_sub(t, t, z1z1, p);
+    p256_mod_sub(t, t, hh, p);
+    
+    /* Y1 * J before a->y may be overwritten */
+    p256_mont_mul(s2, a->y, j, p);
+    memcpy(r->z, t, sizeof(t));
+    
+    /* X3 = r^2 - J - 2 * V */
+    p256_mont_sqr(t, rr, p);
+    p256_mod_sub(t, t, j, p);
+    p256_mod_sub(t, t, v, p);
+    p256_mod_sub(r->x, t, v, p);
+    
+    /* Y3 = r * (V - X3) - 2 * Y1 * J */
+    p256_mod_sub(t, v, r->x, p);
+    p256_mont_mul(t, rr, t, p);
+    p256_mod_add(s2, s2, s2, p);
+    p256_mod_sub(r->y, t, s2, p);
+}
+
+/**
+ * @brief Comb column index: bit (tooth * spacing + column) of k per tooth
+ */
+static uint32_t comb_index(const p256_int_t k, uint32_t column) {
+    uint32_t index = 0;
+    
+    for (uint32_t tooth = 0; tooth < ECDSA_COMB_TEETH; tooth++) {
+        uint32_t bit = tooth * COMB_SPACING + column;
+        if (bit < 256) {
+            index |= ((k[bit >> 5] >> (bit & 31)) & 1) << tooth;
+        }
+    }
+    
+    return index;
+}
+
+/**
+ * @brief r = u1 * G + u2 * Q with the two flash comb tables
+ */
+static void p256_comb_mul2(p256_point_t *r, const p256_int_t u1, const p256_int_t u2) {
+    memset(r, 0, sizeof(*r));
+    
+    for (int32_t column = COMB_SPACING - 1; column >= 0; column--) {
+        p256_point_double(r, r);
+        
+        uint32_t index = comb_index(u1, (uint32_t)column);
+        if (index != 0) {
+            p256_point_add_affine(r, r, &g_ecdsa_comb_g[index - 1]);
+        }
+        
+        index = comb_index(u2, (uint32_t)column);
+        if (index != 0) {
+            p256_point_add_affine(r, r, &g_ecdsa_comb_root[index - 1]);
+        }
+    }
+}
+
+/**
+ * @brief Software verification against the root key
+ */
+static uint32_t ecdsa_verify_sw(const uint8_t *hash, const uint8_t *signature) {
+    p256_int_t r, s, e, w, u1, u2, t, x;
+    p256_point_t sum;
+    volatile uint32_t matches = 0;
+    
+    p256_from_bytes(r, signature);
+    p256_from_bytes(s, signature + 32);
+    p256_from_bytes(e, hash);
+    
+    /* r, s in [1, n - 1] */
+    if (p256_is_zero(r) || p256_is_zero(s) ||
+        !p256_less(r, k_p256_n.m) || !p256_less(s, k_p256_n.m)) {
+        return ECDSA_VERIFY_INVALID;
+    }
+    
+    /* e mod n (e < 2^256 < 2n) */
+    if (!p256_less(e, k_p256_n.m)) {
+        (void)p256_sub_raw(e, e, k_p256_n.m);
+    }
+    
+    /* w = s^-1 (Montgomery), u1 = e * w, u2 = r * w (plain) */
+    p256_mont_mul(t, s, k_p256_n.rr, &k_p256_n);
+    p256_scalar_inv(w, t);
+    p256_mont_mul(u1, e, w, &k_p256_n);
+    p256_mont_mul(u2, r, w, &k_p256_n);
+    
+    p256_comb_mul2(&sum, u1, u2);
+    
+    if (p256_is_zero(sum.z)) {
+        return ECDSA_VERIFY_INVALID;
+    }
+    
+    /* x(R) mod n == r, checked as X == r' * Z^2 for r' = r and r + n < p */
+    p256_mont_sqr(t, sum.z, &k_p256_p);
+    p256_mont_mul(x, r, k_p256_p.rr, &k_p256_p);
+    p256_mont_mul(x, x, t, &k_p256_p);
+    if (p256_equal(x, sum.x)) {
+        matches++;
+    }
+    
+    if (p256_add_raw(u1, r, k_p256_n.m) == 0 && p256_less(u1, k_p256_p.m)) {
+        p256_mont_mul(x, u1, k_p256_p.rr, &k_p256_p);
+        p256_mont_mul(x, x, t, &k_p256_p);
+        if (p256_equal(x, sum.x)) {
+            matches++;
+        }
+    }
+    
+    return (matches == 1) ? ECDSA_VERIFY_VALID : ECDSA_VERIFY_INVALID;
+}
+
+/**
+ * @brief Secure Vault verification against the root key
+ */
+static uint32_t ecdsa_verify_se(const uint8_t *hash, const uint8_t *signature) {
+    /* In production: SE_COMMAND_SIGNATURE_VERIFY with ECDSA P-256,
+     * public key g_ecdsa_root_pubkey passed as input data (or the secure
+     * boot key slot in SE OTP), hash and r || s as further inputs;
+     * SE_executeCommand() and SE_RESPONSE_OK decide the result */
+    
+    /* Simulated accelerator */
+    return ecdsa_verify_sw(hash, signature);
+}
+
+/**
+ * @brief Check whether the Secure Vault can serve verifications
+ */
+bool ecdsa_p256_se_available(void) {
+    return (SEMAILBOX_STATUS & SE_STATUS_READY) != 0;
+}
+
+/**
+ * @brief Verify a signature against the root firmware signing key
+ */
+uint32_t ecdsa_p256_verify(ecdsa_backend_t backend, const uint8_t *hash,
+                           const uint8_t *signature) {
+    uint32_t result;
+    uint32_t start;
+    
+    if (hash == NULL || signature == NULL) {
+        return ECDSA_VERIFY_INVALID;
+    }
+    
+    if (backend == ECDSA_BACKEND_AUTO) {
+        backend = ecdsa_p256_se_available() ? ECDSA_BACKEND_SE : ECDSA_BACKEND_SW_COMB;
+    }
+    
+    start = boot_profile_cycles();
+    
+    switch (backend) {
+    case ECDSA_BACKEND_SE:
+        if (!ecdsa_p256_se_available()) {
+            return ECDSA_VERIFY_INVALID;
+        }
+        result = ecdsa_verify_se(hash, signature);
+        break;
+    
+    case ECDSA_BACKEND_SW_COMB:
+        result = ecdsa_verify_sw(hash, signature);
+        break;
+    
+    default:
+        return ECDSA_VERIFY_INVALID;
+    }
+    
+    ecdsa_stats_t *stats = &g_ecdsa_stats[backend];
+    stats->last_cycles = boot_profile_cycles() - start;
+    if (stats->last_cycles > stats->max_cycles) {
+        stats->max_cycles = stats->last_cycles;
+    }
+    stats->verifications++;
+    if (result != ECDSA_VERIFY_VALID) {
+        stats->failures++;
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Get statistics for one backend
+ */
+bool ecdsa_p256_get_stats(ecdsa_backend_t backend, ecdsa_stats_t *stats) {
+    if (stats == NULL || backend == ECDSA_BACKEND_AUTO || backend >= ECDSA_BACKEND_COUNT) {
+        return false;
+    }
+    
+    memcpy(stats, &g_ecdsa_stats[backend], sizeof(ecdsa_stats_t));
+    
+    return true;
+}
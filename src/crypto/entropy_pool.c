@@ -0,0 +1,234 @@
+/**
+ * @file entropy_pool.c
+ * @brief TRNG Entropy Pool Implementation
+ * 
+ * Single-producer (TRNG ISR) / single-consumer ring buffer. The producer
+ * only advances the head index and the consumer only advances the tail
+ * index, so no locking is needed between the ISR and thread code.
+ */
+
+#include "entropy_pool.h"
+#if defined(SIM_PERIPH_MOCK)
+#include "mock_periph.h"
+#endif
+#include <string.h>
+
+#define ENTROPY_POOL_MASK   (ENTROPY_POOL_WORDS - 1)
+
+/* Ring buffer state */
+static volatile uint32_t g_pool[ENTROPY_POOL_WORDS];
+static volatile uint32_t g_pool_head = 0;   /* Written by ISR only */
+static volatile uint32_t g_pool_tail = 0;   /* Written by consumer only */
+static volatile bool g_refill_pending = false;
+
+static entropy_health_test_t g_health_test = NULL;
+static entropy_pool_stats_t g_pool_stats;
+static uint32_t g_last_trng_word = 0;
+static uint32_t g_fallback_state = 0;
+static bool g_pool_initialized = false;
+
+/* Simulated TRNG FIFO (in production, use TRNG0 peripheral) */
+static uint32_t g_sim_trng_state = 0x6C8E9CF5u;
+
+/**
+ * @brief Read one word from the TRNG FIFO
+ */
+static uint32_t trng_fifo_read(void) {
+    /* In production: return TRNG0->FIFO; */
+
+#if defined(SIM_PERIPH_MOCK)
+    return mock_trng_read();
+#endif
+    
+    /* Simulated TRNG output (xorshift32) */
+    g_sim_trng_state ^= g_sim_trng_state << 13;
+    g_sim_trng_state ^= g_sim_trng_state >> 17;
+    g_sim_trng_state ^= g_sim_trng_state << 5;
+    return g_sim_trng_state;
+}
+
+/**
+ * @brief Enable TRNG FIFO-full interrupt to request a refill burst
+ */
+static void trng_request_refill(void) {
+    if (g_refill_pending) {
+        return;
+    }
+    g_refill_pending = true;
+    
+    /* In production: TRNG0->IEN |= TRNG_IEN_FULLIF;
+     * trng_irq_handler() runs once the FIFO holds TRNG_FIFO_DEPTH words */
+    
+    /* Simulated: FIFO is always full, service immediately */
+    trng_irq_handler();
+    g_refill_pending = false;
+}
+
+/**
+ * @brief Built-in repetition count health test
+ * 
+ * Rejects a burst if any word repeats its predecessor, including across
+ * the boundary with the previous accepted burst.
+ */
+static bool entropy_default_health_test(const uint32_t *words, uint32_t count) {
+    uint32_t prev = g_last_trng_word;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        if (words[i] == prev) {
+            return false;
+        }
+        prev = words[i];
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Start TRNG and fill the pool
+ */
+bool entropy_pool_init(void) {
+    if (g_pool_initialized) {
+        return true;
+    }
+    
+    memset(&g_pool_stats, 0, sizeof(entropy_pool_stats_t));
+    g_pool_head = 0;
+    g_pool_tail = 0;
+    g_refill_pending = false;
+    
+    /* In production: Enable TRNG clock and conditioning
+     * CMU->CLKEN0 |= CMU_CLKEN0_TRNG0;
+     * TRNG0->CONTROL = TRNG_CONTROL_ENABLE | TRNG_CONTROL_REPCOUNTIEN |
+     *                  TRNG_CONTROL_APT64IEN | TRNG_CONTROL_PREIEN;
+     * NVIC_EnableIRQ(TRNG_IRQn);
+     */
+    
+    /* Fill the pool synchronously up front so the boot path never waits */
+    while (entropy_pool_level() < ENTROPY_POOL_WORDS) {
+        uint32_t accepted = g_pool_stats.refills;
+        
+        /* In production: while (TRNG0->FIFOLEVEL < TRNG_FIFO_DEPTH); */
+        trng_irq_handler();
+        
+        if (g_pool_stats.refills == accepted) {
+            return false;  /* Initial burst failed health test */
+        }
+    }
+    
+    g_fallback_state = g_last_trng_word | 1u;
+    g_pool_initialized = true;
+    
+    return true;
+}
+
+/**
+ * @brief Install a health test run on each refill burst
+ */
+void entropy_pool_set_health_test(entropy_health_test_t test) {
+    g_health_test = test;
+}
+
+/**
+ * @brief Read one word from the pool without blocking
+ */
+bool entropy_pool_read(uint32_t *word) {
+    uint32_t tail = g_pool_tail;
+    
+    if (word == NULL) {
+        return false;
+    }
+    
+    if (tail == g_pool_head) {
+        trng_request_refill();
+        return false;
+    }
+    
+    *word = g_pool[tail & ENTROPY_POOL_MASK];
+    g_pool[tail & ENTROPY_POOL_MASK] = 0;
+    g_pool_tail = tail + 1;
+    
+    if (entropy_pool_level() < ENTROPY_POOL_LOW_WATER) {
+        trng_request_refill();
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Get one word for jitter; never blocks
+ */
+uint32_t entropy_pool_get_word(void) {
+    uint32_t word;
+    
+    if (entropy_pool_read(&word)) {
+        return word;
+    }
+    
+    /* Underrun: stir a fallback generator seeded from the last TRNG word */
+    g_pool_stats.underruns++;
+    g_fallback_state ^= g_fallback_state << 13;
+    g_fallback_state ^= g_fallback_state >> 17;
+    g_fallback_state ^= g_fallback_state << 5;
+    
+    return g_fallback_state;
+}
+
+/**
+ * @brief Get number of words currently buffered
+ */
+uint32_t entropy_pool_level(void) {
+    return g_pool_head - g_pool_tail;
+}
+
+/**
+ * @brief Get pool statistics
+ */
+void entropy_pool_get_stats(entropy_pool_stats_t *stats) {
+    if (stats != NULL) {
+        *stats = g_pool_stats;
+    }
+}
+
+/**
+ * @brief TRNG interrupt handler (FIFO full)
+ * 
+ * Drains one FIFO burst, runs the health test and publishes the burst
+ * to the ring only if it passes.
+ */
+void trng_irq_handler(void) {
+    uint32_t burst[TRNG_FIFO_DEPTH];
+    uint32_t head = g_pool_head;
+    entropy_health_test_t test = (g_health_test != NULL) ? g_health_test : entropy_default_health_test;
+    
+    /* In production: Clear interrupt flags
+     * TRNG0->IF_CLR = TRNG0->IF; */
+    
+    for (uint32_t i = 0; i < TRNG_FIFO_DEPTH; i++) {
+        burst[i] = trng_fifo_read();
+    }
+    
+    if (!test(burst, TRNG_FIFO_DEPTH)) {
+        g_pool_stats.health_failures++;
+        /* In production: TRNG0->CONTROL |= TRNG_CONTROL_SOFTRESET; */
+    } else {
+        /* Publish only as many words as fit; the rest are discarded */
+        for (uint32_t i = 0; i < TRNG_FIFO_DEPTH; i++) {
+            if (head - g_pool_tail >= ENTROPY_POOL_WORDS) {
+                break;
+            }
+            g_pool[head & ENTROPY_POOL_MASK] = burst[i];
+            head++;
+        }
+        g_last_trng_word = burst[TRNG_FIFO_DEPTH - 1];
+        g_pool_head = head;
+        g_pool_stats.refills++;
+    }
+    
+    memset(burst, 0, sizeof(burst));
+    
+    /* Keep the interrupt enabled until the pool is above low water */
+    if (g_pool_head - g_pool_tail >= ENTROPY_POOL_LOW_WATER) {
+        /* In production: TRNG0->IEN &= ~TRNG_IEN_FULLIF; */
+        g_refill_pending = false;
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file hmac_sha256.c
+ * @brief HMAC-SHA256 Implementation
+ * 
+ * H((K ^ opad) || H((K ^ ipad) || message)) on top of the software
+ * SHA-256; every intermediate that depends on the key is zeroized.
+ */
+
+#include "hmac_sha256.h"
+#include "zeroize.h"
+#include <string.h>
+
+#define HMAC_IPAD   0x36
+#define HMAC_OPAD   0x5C
+
+/**
+ * @brief Compute HMAC-SHA256 over a list of fragments
+ */
+bool hmac_sha256(const uint8_t *key, uint32_t key_len,
+                 const hmac_sha256_part_t *parts, uint32_t count,
+                 uint8_t *mac, uint32_t mac_len) {
+    uint8_t block_key[SHA256_BLOCK_SIZE];
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_context_t ctx;
+    
+    if (key == NULL || (parts == NULL && count != 0) || mac == NULL ||
+        mac_len == 0 || mac_len > HMAC_SHA256_SIZE) {
+        return false;
+    }
+    
+    /* K0: keys longer than a block are hashed, shorter ones zero-padded */
+    memset(block_key, 0, sizeof(block_key));
+    if (key_len > SHA256_BLOCK_SIZE) {
+        sha256_compute(key, key_len, block_key);
+    } else {
+        memcpy(block_key, key, key_len);
+    }
+    
+    /* Inner: H((K0 ^ ipad) || parts) */
+    for (uint32_t i = 0; i < SHA256_BLOCK_SIZE; i++) {
+        pad[i] = block_key[i] ^ HMAC_IPAD;
+    }
+    sha256_init(&ctx);
+    sha256_update(&ctx, pad, sizeof(pad));
+    for (uint32_t i = 0; i < count; i++) {
+        sha256_update(&ctx, (const uint8_t *)parts[i].data, parts[i].length);
+    }
+    sha256_final(&ctx, digest);
+    
+    /* Outer: H((K0 ^ opad) || inner) */
+    for (uint32_t i = 0; i < SHA256_BLOCK_SIZE; i++) {
+        pad[i] = block_key[i] ^ HMAC_OPAD;
+    }
+    sha256_init(&ctx);
+    sha256_update(&ctx, pad, sizeof(pad));
+    sha256_update(&ctx, digest, sizeof(digest));
+    sha256_final(&ctx, digest);
+    
+    memcpy(mac, digest, mac_len);
+    
+    zeroize_fast(block_key, sizeof(block_key));
+    zeroize_fast(pad, sizeof(pad));
+    zeroize_fast(digest, sizeof(digest));
+    zeroize_fast(&ctx, sizeof(ctx));
+    
+    return true;
+}
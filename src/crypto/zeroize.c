@@ -0,0 +1,190 @@
+/**
+ * @file zeroize.c
+ * @brief Fast Verified Memory Zeroization Implementation
+ * 
+ * The CPU path writes four words per STM on Cortex-M33. The LDMA path
+ * replicates a single zero word into the destination (SRCINC none) and
+ * then verifies with a CPU read-back, since a DMA error or a glitch during
+ * the transfer must not leave secrets behind unnoticed.
+ */
+
+#include "zeroize.h"
+#include "ramfunc.h"
+#include <stddef.h>
+
+/* LDMA channel reserved for zeroization */
+#define ZEROIZE_LDMA_CH     2
+
+/* Source word replicated by the LDMA memset */
+static const uint32_t g_zero_word = 0;
+
+/* Simulated peripheral state (in production, use LDMA registers) */
+static volatile uint32_t LDMA_CHDONE = 0;
+
+/**
+ * @brief Barrier keeping the stores alive and ordered
+ */
+static inline void zeroize_barrier(const void *base) {
+    /* The pointer escapes into asm that may read memory, so the stores
+     * cannot be treated as dead */
+    __asm__ volatile ("" : : "r" (base) : "memory");
+#if defined(__ARM_ARCH_8M_MAIN__)
+    __asm__ volatile ("dsb" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Store zero to aligned words, four per iteration
+ */
+RAMFUNC static volatile uint32_t *zeroize_words(volatile uint32_t *w, uint32_t words) {
+#if defined(__ARM_ARCH_8M_MAIN__)
+    register uint32_t z0 __asm__("r4") = 0;
+    register uint32_t z1 __asm__("r5") = 0;
+    register uint32_t z2 __asm__("r6") = 0;
+    register uint32_t z3 __asm__("r7") = 0;
+    
+    while (words >= 4) {
+        __asm__ volatile ("stmia %0!, {%1, %2, %3, %4}"
+                          : "+r" (w)
+                          : "r" (z0), "r" (z1), "r" (z2), "r" (z3)
+                          : "memory");
+        words -= 4;
+    }
+#else
+    while (words >= 4) {
+        w[0] = 0;
+        w[1] = 0;
+        w[2] = 0;
+        w[3] = 0;
+        w += 4;
+        words -= 4;
+    }
+#endif
+    
+    while (words > 0) {
+        *w++ = 0;
+        words--;
+    }
+    
+    return w;
+}
+
+/**
+ * @brief Zeroize a buffer with CPU word-wide stores
+ */
+RAMFUNC void zeroize_fast(void *base, uint32_t length) {
+    volatile uint8_t *p = (volatile uint8_t *)base;
+    
+    if (base == NULL) {
+        return;
+    }
+    
+    /* Leading bytes up to word alignment */
+    while (length > 0 && ((uintptr_t)p & 3U) != 0) {
+        *p++ = 0;
+        length--;
+    }
+    
+    p = (volatile uint8_t *)zeroize_words((volatile uint32_t *)p, length / 4);
+    length &= 3U;
+    
+    /* Trailing bytes */
+    while (length > 0) {
+        *p++ = 0;
+        length--;
+    }
+    
+    zeroize_barrier(base);
+}
+
+/**
+ * @brief Zeroize aligned words with LDMA
+ */
+RAMFUNC static void zeroize_dma(volatile uint32_t *dst, uint32_t words) {
+    while (words > 0) {
+        uint32_t n = (words > ZEROIZE_DMA_MAX_WORDS) ? ZEROIZE_DMA_MAX_WORDS : words;
+        
+        /* In production (channel must be Secure in the SMU to reach Secure RAM):
+         * desc.CTRL = LDMA_CTRL_SIZE_WORD | LDMA_CTRL_SRCINC_NONE |
+         *             LDMA_CTRL_DSTINC_ONE | LDMA_CTRL_XFERCNT(n - 1) |
+         *             LDMA_CTRL_REQMODE_ALL | LDMA_CTRL_STRUCTREQ;
+         * desc.SRC  = (uint32_t)&g_zero_word;
+         * desc.DST  = (uint32_t)dst;
+         * LDMA->CH[ZEROIZE_LDMA_CH].LINK = (uint32_t)&desc;
+         * LDMA->LINKLOAD = 1 << ZEROIZE_LDMA_CH;
+         * while (!(LDMA->CHDONE & (1 << ZEROIZE_LDMA_CH))) { }
+         * LDMA->CHDONE_CLR = 1 << ZEROIZE_LDMA_CH;
+         */
+        
+        /* Simulated transfer */
+        for (uint32_t i = 0; i < n; i++) {
+            dst[i] = g_zero_word;
+        }
+        LDMA_CHDONE = 1U << ZEROIZE_LDMA_CH;
+        
+        while ((LDMA_CHDONE & (1U << ZEROIZE_LDMA_CH)) == 0) {
+            /* Wait for transfer */
+        }
+        LDMA_CHDONE = 0;
+        
+        dst += n;
+        words -= n;
+    }
+}
+
+/**
+ * @brief Check that a region is all zero
+ */
+RAMFUNC bool zeroize_verify(const void *base, uint32_t length) {
+    const volatile uint8_t *p = (const volatile uint8_t *)base;
+    uint32_t acc = 0;
+    
+    if (base == NULL) {
+        return false;
+    }
+    
+    while (length > 0 && ((uintptr_t)p & 3U) != 0) {
+        acc |= *p++;
+        length--;
+    }
+    
+    const volatile uint32_t *w = (const volatile uint32_t *)p;
+    for (uint32_t i = 0; i < length / 4; i++) {
+        acc |= w[i];
+    }
+    
+    p = (const volatile uint8_t *)&w[length / 4];
+    for (uint32_t i = 0; i < (length & 3U); i++) {
+        acc |= p[i];
+    }
+    
+    return acc == 0;
+}
+
+/**
+ * @brief Zeroize a region and verify it reads back as zero
+ */
+RAMFUNC bool zeroize_region(void *base, uint32_t length) {
+    if (base == NULL) {
+        return false;
+    }
+    
+    if (length < ZEROIZE_DMA_THRESHOLD) {
+        zeroize_fast(base, length);
+        return zeroize_verify(base, length);
+    }
+    
+    /* Unaligned edges by CPU, aligned body by LDMA */
+    uintptr_t start = (uintptr_t)base;
+    uintptr_t body = (start + 3U) & ~(uintptr_t)3U;
+    uint32_t head = (uint32_t)(body - start);
+    uint32_t words = (length - head) / 4;
+    uint32_t tail = (length - head) & 3U;
+    
+    zeroize_fast(base, head);
+    zeroize_dma((volatile uint32_t *)body, words);
+    zeroize_fast((uint8_t *)body + words * 4, tail);
+    zeroize_barrier(base);
+    
+    return zeroize_verify(base, length);
+}
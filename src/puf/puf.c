@@ -7,29 +7,63 @@
  */
 
 #include "puf.h"
+#include "ramfunc.h"
+#include "tamper_detection.h"
+#include "zeroize.h"
 #include <string.h>
+#if defined(SIM_PERIPH_MOCK)
+#include "mock_periph.h"
+#endif
+
+/* PUF session states - non-binary values for glitch resistance */
+#define PUF_SESSION_CLOSED      0x00000000
+#define PUF_SESSION_OPEN        0x6A95C35A
+#define PUF_SESSION_OPENING     0x953A5CA3   /* Reconstruction posted to the SE */
+#define PUF_SESSION_ABORTED     0x3AC5A695   /* Zeroized while OPENING; response dropped */
 
 /* PUF state */
 static puf_config_t g_puf_config;
 static bool g_puf_initialized = false;
+
+/* Session root key slot (in production, placed in an MPU-locked
+ * privileged-only Secure RAM region) */
 static uint8_t g_puf_key[PUF_KEY_SIZE];
+static volatile uint32_t g_puf_session_state = PUF_SESSION_CLOSED;
+static uint32_t g_puf_session_depth = 0;
 
 /* Simulated PUF helper data (in production, stored in OTP) */
 static uint8_t g_puf_helper_data[64];
 
+/**
+ * @brief Mask interrupts, returning the previous PRIMASK (no-op on host)
+ */
+static inline uint32_t puf_irq_save(void) {
+#if defined(__arm__)
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+    return primask;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Restore PRIMASK from puf_irq_save()
+ */
+static inline void puf_irq_restore(uint32_t primask) {
+#if defined(__arm__)
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+#else
+    (void)primask;
+#endif
+}
+
 /**
  * @brief Secure memory zeroization
  */
-void secure_zeroize(uint8_t *key, uint32_t size) {
-    /* Use volatile to prevent compiler optimization */
-    volatile uint8_t *p = key;
-    
-    while (size--) {
-        *p++ = 0;
-    }
-    
-    /* Memory barrier to ensure writes complete */
-    __asm__ volatile ("" ::: "memory");
+RAMFUNC void secure_zeroize(uint8_t *key, uint32_t size) {
+    /* Word-wide stores with a non-elidable barrier */
+    zeroize_fast(key, size);
 }
 
 /**
@@ -60,6 +94,11 @@ bool puf_init(void) {
     /* Initialize SE (Secure Element) mailbox for PUF operations */
     /* SE_executeCommand(&cmd); */
     
+    /* The tamper wipe then also reads the session key slot back as zero */
+    if (!tamper_register_secret(g_puf_key, sizeof(g_puf_key))) {
+        return false;
+    }
+    
     g_puf_initialized = true;
     
     return true;
@@ -86,7 +125,7 @@ bool puf_enroll(void) {
      */
     
     /* Simulated enrollment - generate placeholder helper data */
-    for (int i = 0; i < sizeof(g_puf_helper_data); i++) {
+    for (uint32_t i = 0; i < sizeof(g_puf_helper_data); i++) {
         g_puf_helper_data[i] = (uint8_t)(i ^ 0xA5);
     }
     
@@ -122,19 +161,156 @@ bool puf_reconstruct_key(uint8_t *key_output, uint32_t key_size) {
      * 4. Apply error correction using helper data
      * 5. Reconstruct stable key
      */
+
+#if defined(SIM_PERIPH_MOCK)
+    /* Modeled SE round trip: poll RX_STATUS until the response lands */
+    for (uint32_t n = g_mock_periph.se_puf_polls; n != 0; n--) {
+        (void)g_mock_periph.semailbox_status;
+    }
+#endif
     
     /* Simulated key reconstruction */
     for (int i = 0; i < PUF_KEY_SIZE; i++) {
-        g_puf_key[i] = g_puf_helper_data[i % sizeof(g_puf_helper_data)] ^ 0x5A;
+        key_output[i] = g_puf_helper_data[i % sizeof(g_puf_helper_data)] ^ 0x5A;
     }
     
-    memcpy(key_output, g_puf_key, PUF_KEY_SIZE);
-    
     g_puf_config.reconstruction_count++;
     
     return true;
 }
 
+/**
+ * @brief Open a PUF session
+ */
+bool puf_session_open(void) {
+    if (!g_puf_initialized) {
+        return false;
+    }
+    
+    if (g_puf_session_state == PUF_SESSION_OPEN) {
+        g_puf_session_depth++;
+        return true;
+    }
+    
+    /* The SE already holds the step's command; join that job instead */
+    if (g_puf_session_state == PUF_SESSION_OPENING) {
+        return false;
+    }
+    
+    /* Single reconstruction for the whole session */
+    if (!puf_reconstruct_key(g_puf_key, sizeof(g_puf_key))) {
+        secure_zeroize(g_puf_key, sizeof(g_puf_key));
+        return false;
+    }
+    
+    /* In production: Lock the key slot against non-privileged access
+     * MPU->RNR = PUF_KEY_MPU_REGION; MPU->RLAR |= MPU_RLAR_EN_Msk; */
+    
+    g_puf_session_depth = 1;
+    g_puf_session_state = PUF_SESSION_OPEN;
+    
+    return true;
+}
+
+/**
+ * @brief Open a PUF session without waiting on the Secure Vault
+ */
+boot_job_status_t puf_session_open_step(void *ctx) {
+    uint8_t scratch[PUF_KEY_SIZE];
+    uint32_t primask;
+    bool committed;
+    
+    (void)ctx;
+    
+    if (!g_puf_initialized) {
+        return BOOT_JOB_FAILED;
+    }
+    
+    if (g_puf_session_state == PUF_SESSION_OPEN) {
+        g_puf_session_depth++;
+        return BOOT_JOB_DONE;
+    }
+    
+    /* Zeroized while in flight: the key must not land after the wipe.
+     * In production: SE_readCommandResponse() into a scratch buffer,
+     * which is zeroized unread */
+    if (g_puf_session_state == PUF_SESSION_ABORTED) {
+        g_puf_session_state = PUF_SESSION_CLOSED;
+        return BOOT_JOB_FAILED;
+    }
+    
+    if (g_puf_session_state != PUF_SESSION_OPENING) {
+        if (!g_puf_config.enrollment_done) {
+            return BOOT_JOB_FAILED;
+        }
+        
+        /* In production: SE_writeCommand() posts the reconstruction here;
+         * SE_readCommandResponse() collects it on a later step */
+        g_puf_session_state = PUF_SESSION_OPENING;
+        return BOOT_JOB_PENDING;
+    }
+    
+    /* In production: if (!(SEMAILBOX_HOST->RX_STATUS & SEMAILBOX_RX_STATUS_RXINT))
+     * return BOOT_JOB_PENDING; then read the key from the response buffer.
+     * Into scratch: a tamper wipe may run before it is committed */
+    if (!puf_reconstruct_key(scratch, sizeof(scratch))) {
+        secure_zeroize(scratch, sizeof(scratch));
+        g_puf_session_state = PUF_SESSION_CLOSED;
+        return BOOT_JOB_FAILED;
+    }
+    
+    /* Commit only if no zeroize moved OPENING to ABORTED meanwhile */
+    primask = puf_irq_save();
+    committed = (g_puf_session_state == PUF_SESSION_OPENING);
+    if (committed) {
+        memcpy(g_puf_key, scratch, sizeof(g_puf_key));
+        g_puf_session_depth = 1;
+        g_puf_session_state = PUF_SESSION_OPEN;
+    } else {
+        g_puf_session_state = PUF_SESSION_CLOSED;
+    }
+    puf_irq_restore(primask);
+    
+    secure_zeroize(scratch, sizeof(scratch));
+    
+    return committed ? BOOT_JOB_DONE : BOOT_JOB_FAILED;
+}
+
+/**
+ * @brief Close a PUF session
+ */
+void puf_session_close(void) {
+    if (g_puf_session_state != PUF_SESSION_OPEN) {
+        return;
+    }
+    
+    if (g_puf_session_depth > 1) {
+        g_puf_session_depth--;
+        return;
+    }
+    
+    puf_session_zeroize();
+}
+
+/**
+ * @brief Zeroize the session root key immediately, regardless of nesting
+ */
+RAMFUNC void puf_session_zeroize(void) {
+    /* A pending open is cancelled, not left to complete after the wipe */
+    uint32_t state = g_puf_session_state;
+    g_puf_session_state = (state == PUF_SESSION_OPENING || state == PUF_SESSION_ABORTED)
+                          ? PUF_SESSION_ABORTED : PUF_SESSION_CLOSED;
+    g_puf_session_depth = 0;
+    secure_zeroize(g_puf_key, sizeof(g_puf_key));
+}
+
+/**
+ * @brief Check if a PUF session is open
+ */
+bool puf_session_active(void) {
+    return g_puf_session_state == PUF_SESSION_OPEN;
+}
+
 /**
  * @brief Derive key from PUF with additional context
  */
@@ -144,9 +320,11 @@ bool puf_derive_key(const uint8_t *context, uint32_t context_len,
         return false;
     }
     
-    /* Reconstruct base PUF key */
+    /* Use the session root key if cached, otherwise reconstruct */
     uint8_t base_key[PUF_KEY_SIZE];
-    if (!puf_reconstruct_key(base_key, sizeof(base_key))) {
+    if (g_puf_session_state == PUF_SESSION_OPEN) {
+        memcpy(base_key, g_puf_key, PUF_KEY_SIZE);
+    } else if (!puf_reconstruct_key(base_key, sizeof(base_key))) {
         return false;
     }
     
@@ -222,20 +400,11 @@ bool puf_wrap_key(const uint8_t *plaintext_key, uint32_t key_size,
 }
 
 /**
- * @brief Unwrap a key using PUF-derived wrapping key
+ * @brief Unwrap one key with an already derived wrapping key
  */
-bool puf_unwrap_key(const wrapped_key_t *wrapped, uint8_t *plaintext_key,
-                    uint32_t key_size) {
-    if (!g_puf_initialized || wrapped == NULL || plaintext_key == NULL) {
-        return false;
-    }
-    
-    /* Derive wrapping key from PUF */
-    uint8_t wrapping_key[PUF_KEY_SIZE];
-    const uint8_t kek_context[] = "KEY_WRAPPING_v1";
-    
-    if (!puf_derive_key(kek_context, sizeof(kek_context) - 1,
-                        wrapping_key, sizeof(wrapping_key))) {
+static bool puf_unwrap_with_kek(const uint8_t *wrapping_key, const wrapped_key_t *wrapped,
+                                uint8_t *plaintext_key, uint32_t key_size) {
+    if (key_size == 0 || key_size > WRAPPED_KEY_SIZE - 16) {
         return false;
     }
     
@@ -260,9 +429,6 @@ bool puf_unwrap_key(const wrapped_key_t *wrapped, uint8_t *plaintext_key,
         diff |= (expected_tag[i] ^ wrapped->tag[i]);
     }
     
-    /* Zeroize wrapping key */
-    secure_zeroize(wrapping_key, sizeof(wrapping_key));
-    
     if (diff != 0) {
         /* Tag verification failed - zeroize output */
         secure_zeroize(plaintext_key, key_size);
@@ -271,3 +437,81 @@ bool puf_unwrap_key(const wrapped_key_t *wrapped, uint8_t *plaintext_key,
     
     return true;
 }
+
+/**
+ * @brief Unwrap a key using PUF-derived wrapping key
+ */
+bool puf_unwrap_key(const wrapped_key_t *wrapped, uint8_t *plaintext_key,
+                    uint32_t key_size) {
+    if (!g_puf_initialized || wrapped == NULL || plaintext_key == NULL) {
+        return false;
+    }
+    
+    /* Derive wrapping key from PUF */
+    uint8_t wrapping_key[PUF_KEY_SIZE];
+    const uint8_t kek_context[] = "KEY_WRAPPING_v1";
+    
+    if (!puf_derive_key(kek_context, sizeof(kek_context) - 1,
+                        wrapping_key, sizeof(wrapping_key))) {
+        return false;
+    }
+    
+    bool result = puf_unwrap_with_kek(wrapping_key, wrapped, plaintext_key, key_size);
+    
+    /* Zeroize wrapping key */
+    secure_zeroize(wrapping_key, sizeof(wrapping_key));
+    
+    return result;
+}
+
+/**
+ * @brief Unwrap multiple keys with a single wrapping key derivation
+ */
+uint32_t puf_unwrap_keys(const wrapped_key_t *wrapped, size_t count,
+                         uint8_t *plaintext_keys, uint32_t key_size, bool *status) {
+    if (!g_puf_initialized || wrapped == NULL || plaintext_keys == NULL || status == NULL) {
+        return 0;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        status[i] = false;
+    }
+    
+    /* Derive wrapping key once for the whole batch */
+    uint8_t wrapping_key[PUF_KEY_SIZE];
+    const uint8_t kek_context[] = "KEY_WRAPPING_v1";
+    
+    if (!puf_derive_key(kek_context, sizeof(kek_context) - 1,
+                        wrapping_key, sizeof(wrapping_key))) {
+        return 0;
+    }
+    
+    /* In production: Load the wrapping key into a volatile SE key slot
+     * once, then queue up to PUF_UNWRAP_BATCH_MAX AES-KW unwrap commands
+     * per mailbox submission referencing that slot:
+     * SE_addParameter(&cmd, key_slot); SE_executeCommand(&cmd_queue);
+     */
+    
+    uint32_t unwrapped = 0;
+    
+    for (size_t base = 0; base < count; base += PUF_UNWRAP_BATCH_MAX) {
+        size_t batch = count - base;
+        if (batch > PUF_UNWRAP_BATCH_MAX) {
+            batch = PUF_UNWRAP_BATCH_MAX;
+        }
+        
+        /* Simulated queued command sequence */
+        for (size_t i = base; i < base + batch; i++) {
+            status[i] = puf_unwrap_with_kek(wrapping_key, &wrapped[i],
+                                            &plaintext_keys[i * key_size], key_size);
+            if (status[i]) {
+                unwrapped++;
+            }
+        }
+    }
+    
+    /* Single zeroize sweep of the wrapping key */
+    secure_zeroize(wrapping_key, sizeof(wrapping_key));
+    
+    return unwrapped;
+}
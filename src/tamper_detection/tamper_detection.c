@@ -3,20 +3,203 @@
  * @brief Active Tamper Detection Implementation for EFR32MG26
  * 
  * Implements preemptive anti-tamper monitoring using ACMP for voltage
- * glitch detection and IADC for temperature anomaly detection.
+ * glitch detection and IADC for temperature anomaly detection. Thresholds
+ * live in the peripherals (ACMP reference dividers, IADC CMPTHR window);
+ * each interrupt handler evaluates only its own source and latches the
+ * result for check_tamper_events(). Supply voltage is also scanned by the
+ * IADC into an LDMA circular buffer and checked once per half buffer.
  */
 
 #include "tamper_detection.h"
+#include "attestation.h"
+#include "puf.h"
+#include "ramfunc.h"
+#include "zeroize.h"
 #include <string.h>
+#if defined(SIM_PERIPH_MOCK)
+#include "mock_periph.h"
+#endif
+
+/* ACMP interrupt flags and status (EFR32 Series 2 layout) */
+#define ACMP_IF_RISE            (1UL << 0)
+#define ACMP_IF_FALL            (1UL << 1)
+#define ACMP_STATUS_ACMPOUT     (1UL << 2)
+
+/* IADC interrupt flags and status */
+#define IADC_IF_SINGLECMP       (1UL << 2)
+#define IADC_STATUS_SINGLEFIFODV (1UL << 8)
+
+/* Internal temperature sensor transfer function (12-bit result) */
+#define IADC_TEMP_CODE_AT_0C    1600
+#define IADC_TEMP_CODE_PER_C    4
+
+/* Supply scan input: AVDD/4 against 1.21V reference (12-bit result) */
+#define IADC_SUPPLY_CODE_TO_MV(code)    (((uint32_t)(code) * 1210U * 4U) / 4095U)
+#define IADC_SUPPLY_MV_TO_CODE(mv)      (((uint32_t)(mv) * 4095U) / (1210U * 4U))
+
+/* LDMA channel and flags for the supply scan */
+#define TAMPER_LDMA_CH          1
+#define LDMA_IF_DONE(ch)        (1UL << (ch))
+
+/* Running mean weight: new = old + (block - old) / 2^SHIFT */
+#define TAMPER_MEAN_EWMA_SHIFT  3
+
+#define IADC_TEMP_TO_CODE(c)    ((uint32_t)(IADC_TEMP_CODE_AT_0C + (c) * IADC_TEMP_CODE_PER_C))
+#define IADC_CODE_TO_TEMP(code) (((int32_t)(code) - IADC_TEMP_CODE_AT_0C) / IADC_TEMP_CODE_PER_C)
 
 /* Global tamper context */
 static tamper_context_t g_tamper_context;
 static acmp_config_t g_acmp_config;
 static iadc_config_t g_iadc_config;
 
+/* Events latched by interrupt handlers, consumed by check_tamper_events() */
+static volatile uint32_t g_pending_events = TAMPER_EVENT_NONE;
+static uint8_t g_tamper_string_id = EVENT_STRING_NONE;
+
+/* Secret region registered for tamper zeroization */
+typedef struct {
+    void *base;
+    uint32_t length;
+} tamper_secret_region_t;
+
+static tamper_secret_region_t g_secret_regions[TAMPER_SECRET_REGION_MAX];
+static volatile uint32_t g_secret_count = 0;
+static tamper_reset_action_t g_reset_action = TAMPER_RESET_SYSRESETREQ;
+
+/* Supply sample ring filled by LDMA; halves alternate between DMA and CPU */
+static volatile uint16_t g_supply_samples[TAMPER_SAMPLE_BUFFER_SIZE];
+static uint32_t g_supply_half = 0;          /* Half the next interrupt completes */
+static uint32_t g_supply_last_mv = 0;       /* Last sample of previous block */
+static tamper_window_stats_t g_window_stats;
+
+#if defined(__ARM_FEATURE_CMSE)
+/* Application Interrupt and Reset Control */
+#define SCB_AIRCR               (*(volatile uint32_t *)0xE000ED0CUL)
+#endif
+
+#define AIRCR_VECTKEY           (0x05FAUL << 16)
+#define AIRCR_PRIGROUP_MASK     (0x7UL << 8)
+#define AIRCR_SYSRESETREQ       (1UL << 2)
+
+/* Retained tamper record words (BURAM on target) */
+#define TAMPER_RECORD_WORDS     (sizeof(tamper_record_t) / sizeof(uint32_t))
+static volatile uint32_t BURAM_RET[TAMPER_RECORD_WORDS];
+
 /* Simulated peripheral registers (in production, use actual EFR32 registers) */
-static volatile uint32_t ACMP_STATUS = 0;
-static volatile uint32_t IADC_TEMP_VALUE = 25;
+#if defined(SIM_PERIPH_MOCK)
+#define ACMP0_IF                (g_mock_periph.acmp0_if)
+#define ACMP0_STATUS            (g_mock_periph.acmp0_status)
+#define ACMP1_IF                (g_mock_periph.acmp1_if)
+#define ACMP1_STATUS            (g_mock_periph.acmp1_status)
+#define IADC0_IF                (g_mock_periph.iadc0_if)
+#define IADC0_STATUS            (g_mock_periph.iadc0_status)
+#define IADC0_CMPTHR            (g_mock_periph.iadc0_cmpthr)
+#define IADC0_SINGLEFIFODATA    (g_mock_periph.iadc0_singlefifodata)
+#define LDMA_IF                 (g_mock_periph.ldma_if)
+#else
+static volatile uint32_t ACMP0_IF = 0;          /* Undervoltage comparator */
+static volatile uint32_t ACMP0_STATUS = ACMP_STATUS_ACMPOUT;
+static volatile uint32_t ACMP1_IF = 0;          /* Overvoltage comparator */
+static volatile uint32_t ACMP1_STATUS = 0;
+static volatile uint32_t IADC0_IF = 0;
+static volatile uint32_t IADC0_STATUS = 0;
+static volatile uint32_t IADC0_CMPTHR = 0;
+static volatile uint32_t IADC0_SINGLEFIFODATA = IADC_TEMP_TO_CODE(TEMP_NOMINAL_C);
+static volatile uint32_t LDMA_IF = 0;
+#endif
+
+/**
+ * @brief Start IADC supply scan with LDMA into the circular buffer
+ * 
+ * Two linked descriptors each fill one half of the buffer and raise DONE,
+ * the second links back to the first, so the CPU wakes once per block.
+ */
+static void iadc_supply_scan_start(uint32_t sample_rate) {
+    /* Prime with nominal samples so the first block has a sane baseline */
+    uint16_t nominal = (uint16_t)IADC_SUPPLY_MV_TO_CODE(VOLTAGE_NOMINAL_MV);
+    for (uint32_t i = 0; i < TAMPER_SAMPLE_BUFFER_SIZE; i++) {
+        g_supply_samples[i] = nominal;
+    }
+    
+    g_supply_half = 0;
+    g_supply_last_mv = VOLTAGE_NOMINAL_MV;
+    memset(&g_window_stats, 0, sizeof(g_window_stats));
+    g_window_stats.running_mean_mv = VOLTAGE_NOMINAL_MV;
+    LDMA_IF = 0;
+    
+    /* In production:
+     * IADC0->SCAN0 = IADC_SCAN_PORTPOS_SUPPLY (AVDD/4);
+     * IADC0->SCANFIFOCFG = IADC_SCANFIFOCFG_DVL_VALID1 | IADC_SCANFIFOCFG_DMAWUFIFOSCAN;
+     * IADC0->TIMER = (IADC clock) / sample_rate;
+     * IADC0->TRIGGER |= IADC_TRIGGER_SCANTRIGSEL_TIMER;
+     * 
+     * desc[0]: SCANFIFODATA -> &g_supply_samples[0], halfword, BLOCK_SIZE, DONEIEN, link desc[1]
+     * desc[1]: SCANFIFODATA -> &g_supply_samples[BLOCK_SIZE], halfword, BLOCK_SIZE, DONEIEN, link desc[0]
+     * LDMAXBAR->CH[TAMPER_LDMA_CH].REQSEL = LDMAXBAR_CH_REQSEL_SIGSEL_IADC0IADC_SCAN;
+     * LDMA->CH[TAMPER_LDMA_CH].LINK = (uint32_t)&desc[0];
+     * LDMA->IEN |= LDMA_IF_DONE(TAMPER_LDMA_CH);
+     * LDMA->LINKLOAD = 1 << TAMPER_LDMA_CH;
+     * IADC0->CMD = IADC_CMD_SCANSTART;
+     */
+    (void)sample_rate;
+}
+
+/**
+ * @brief Compute statistics for one block and derive tamper events
+ */
+RAMFUNC static uint32_t tamper_process_block(const volatile uint16_t *samples, uint32_t count) {
+    uint32_t events = TAMPER_EVENT_NONE;
+    uint32_t prev = g_supply_last_mv;
+    uint32_t sum = 0;
+    uint32_t min_mv = UINT32_MAX;
+    uint32_t max_mv = 0;
+    uint32_t max_slew = 0;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t mv = IADC_SUPPLY_CODE_TO_MV(samples[i]);
+        uint32_t slew = (mv > prev) ? (mv - prev) : (prev - mv);
+        
+        sum += mv;
+        min_mv = (mv < min_mv) ? mv : min_mv;
+        max_mv = (mv > max_mv) ? mv : max_mv;
+        max_slew = (slew > max_slew) ? slew : max_slew;
+        prev = mv;
+    }
+    
+    uint32_t running = g_window_stats.running_mean_mv;
+    
+    g_supply_last_mv = prev;
+    g_window_stats.mean_mv = sum / count;
+    g_window_stats.min_mv = min_mv;
+    g_window_stats.max_mv = max_mv;
+    g_window_stats.max_slew_mv = max_slew;
+    g_window_stats.blocks++;
+    
+    /* Level faults the comparators may have missed between edges */
+    if (min_mv < g_acmp_config.low_threshold) {
+        events |= TAMPER_EVENT_VOLTAGE_LOW;
+    }
+    if (max_mv > g_acmp_config.high_threshold) {
+        events |= TAMPER_EVENT_VOLTAGE_HIGH;
+    }
+    
+    /* Fast edges, or a single-sample spike away from the baseline */
+    if (max_slew > TAMPER_SLEW_LIMIT_MV ||
+        max_mv > running + TAMPER_DEVIATION_LIMIT_MV ||
+        min_mv + TAMPER_DEVIATION_LIMIT_MV < running) {
+        events |= TAMPER_EVENT_GLITCH;
+    }
+    
+    /* Baseline only follows clean blocks so an attack cannot drag it */
+    if (events == TAMPER_EVENT_NONE) {
+        int32_t delta = (int32_t)g_window_stats.mean_mv - (int32_t)running;
+        g_window_stats.running_mean_mv = (uint32_t)((int32_t)running + delta / (1 << TAMPER_MEAN_EWMA_SHIFT));
+    }
+    
+    g_tamper_context.last_voltage_mv = g_window_stats.mean_mv;
+    
+    return events;
+}
 
 /**
  * @brief Initialize ACMP peripheral for voltage monitoring
@@ -26,35 +209,44 @@ bool acmp_init(const acmp_config_t *config) {
         return false;
     }
     
+    if (config->low_threshold >= config->high_threshold) {
+        return false;
+    }
+    
     /* Store configuration */
     memcpy(&g_acmp_config, config, sizeof(acmp_config_t));
     
-    /* In production: Configure EFR32 ACMP peripheral
-     * - Set up voltage comparator thresholds
-     * - Configure hysteresis
-     * - Enable interrupts
-     * - Connect to supply voltage monitoring
-     */
-    
     /* Configure ACMP for voltage monitoring
-     * Reference: EFR32MG26 Reference Manual, ACMP chapter */
-    
-    /* Enable ACMP clock */
-    /* CMU->CLKEN0 |= CMU_CLKEN0_ACMP0; */
-    
-    /* Configure ACMP input channels */
-    /* ACMP0->INPUTSEL = ACMP_INPUTSEL_POSSEL_AVDD | ACMP_INPUTSEL_NEGSEL_VREFDIV2V5; */
-    
-    /* Set threshold levels */
-    /* Use ACMP capsense mode for precise voltage detection */
-    
-    /* Enable edge interrupts for glitch detection */
+     * Reference: EFR32MG26 Reference Manual, ACMP chapter
+     * 
+     * Two comparators form the supply window: ACMP0 trips below
+     * low_threshold, ACMP1 above high_threshold. The thresholds are set
+     * with the VREF dividers, so no software compare is needed. */
+    
+    /* Enable ACMP clocks */
+    /* CMU->CLKEN0 |= CMU_CLKEN0_ACMP0 | CMU_CLKEN0_ACMP1; */
+    
+    /* Compare divided AVDD against the scaled reference */
+    /* ACMP0->INPUTSEL = ACMP_INPUTSEL_POSSEL_AVDDDIV | ACMP_INPUTSEL_NEGSEL_VREFDIV1V25; */
+    /* ACMP0->INPUTCTRL = ACMP_INPUTCTRL_VREFDIV(acmp_vrefdiv(config->low_threshold)); */
+    /* ACMP1->INPUTSEL = ACMP_INPUTSEL_POSSEL_AVDDDIV | ACMP_INPUTSEL_NEGSEL_VREFDIV1V25; */
+    /* ACMP1->INPUTCTRL = ACMP_INPUTCTRL_VREFDIV(acmp_vrefdiv(config->high_threshold)); */
+    
+    /* Hysteresis keeps a slow supply from chattering around a threshold */
+    /* ACMP0->CFG = ACMP_CFG_HYST(config->hysteresis); */
+    /* ACMP1->CFG = ACMP_CFG_HYST(config->hysteresis); */
+    
+    /* Both edges interrupt: a rise and fall latched together is a glitch */
+    ACMP0_IF = 0;
+    ACMP1_IF = 0;
     if (config->interrupt_enabled) {
-        /* ACMP0->IEN = ACMP_IEN_EDGE | ACMP_IEN_WARMUP; */
+        /* ACMP0->IEN = ACMP_IEN_RISE | ACMP_IEN_FALL; */
+        /* ACMP1->IEN = ACMP_IEN_RISE | ACMP_IEN_FALL; */
+        /* NVIC_EnableIRQ(ACMP0_IRQn); NVIC_EnableIRQ(ACMP1_IRQn); */
     }
     
-    /* Enable ACMP */
-    /* ACMP0->EN = ACMP_EN_EN; */
+    /* Enable ACMP (runs in EM2) */
+    /* ACMP0->EN = ACMP_EN_EN; ACMP1->EN = ACMP_EN_EN; */
     
     return true;
 }
@@ -67,16 +259,13 @@ bool iadc_init(const iadc_config_t *config) {
         return false;
     }
     
+    if ((int32_t)config->temp_low_threshold >= (int32_t)config->temp_high_threshold) {
+        return false;
+    }
+    
     /* Store configuration */
     memcpy(&g_iadc_config, config, sizeof(iadc_config_t));
     
-    /* In production: Configure EFR32 IADC peripheral
-     * - Set up temperature sensor input
-     * - Configure sample rate and resolution
-     * - Set threshold comparators
-     * - Enable continuous monitoring if requested
-     */
-    
     /* Configure IADC for temperature monitoring
      * Reference: EFR32MG26 Reference Manual, IADC chapter */
     
@@ -87,22 +276,38 @@ bool iadc_init(const iadc_config_t *config) {
     /* IADC0->SINGLEFIFOCFG = IADC_SINGLEFIFOCFG_ALIGNMENT_RIGHT12; */
     
     /* Select internal temperature sensor */
-    /* IADC0->SCAN0CFG = IADC_SCAN0CFG_FIFODVL_VALID1; */
+    /* IADC0->SINGLE = IADC_SINGLE_PORTPOS_TEMP | IADC_SINGLE_CMP; */
     
     /* Set sample rate */
     /* IADC0->TIMER = config->sample_rate; */
     
-    /* Configure thresholds for temperature monitoring */
-    /* IADC0->CMPTHR = (config->temp_high_threshold << 16) | config->temp_low_threshold; */
+    /* Window comparator: interrupt only for samples outside [low, high] */
+    IADC0_CMPTHR = (IADC_TEMP_TO_CODE((int32_t)config->temp_high_threshold) << 16) |
+                   IADC_TEMP_TO_CODE((int32_t)config->temp_low_threshold);
+    /* IADC0->CMPTHR = IADC0_CMPTHR; */
     
-    /* Enable continuous mode if requested */
+    IADC0_IF = 0;
+    /* IADC0->IEN = IADC_IEN_SINGLECMP; NVIC_EnableIRQ(IADC_IRQn); */
+    
+    /* Timer-triggered conversions need no CPU wakeup per sample */
     if (config->continuous_mode) {
-        /* IADC0->TRIGGER = IADC_TRIGGER_SCANTRIGSEL_TIMER; */
+        /* IADC0->TRIGGER = IADC_TRIGGER_SINGLETRIGSEL_TIMER | IADC_TRIGGER_SINGLETAILGATE; */
+    }
+    
+    /* Supply scan results go straight to RAM via LDMA */
+    if (config->supply_scan) {
+        if (config->sample_rate == 0) {
+            return false;
+        }
+        iadc_supply_scan_start(config->sample_rate);
     }
     
     /* Enable IADC */
     /* IADC0->EN = IADC_EN_EN; */
     
+    /* Simulated: first conversion lands once the IADC has warmed up */
+    IADC0_STATUS |= IADC_STATUS_SINGLEFIFODV;
+    
     return true;
 }
 
@@ -117,6 +322,14 @@ bool tamper_detection_start(tamper_context_t *context) {
     /* Initialize context */
     memset(context, 0, sizeof(tamper_context_t));
     g_tamper_context = *context;
+    g_pending_events = TAMPER_EVENT_NONE;
+    
+    /* Intern the log string here; handlers log by ID without locks */
+    g_tamper_string_id = attestation_intern_string("tamper");
+    
+    /* Set initial measurements */
+    g_tamper_context.last_voltage_mv = VOLTAGE_NOMINAL_MV;
+    g_tamper_context.last_temp_c = TEMP_NOMINAL_C;
     
     /* Configure ACMP for voltage monitoring */
     acmp_config_t acmp_cfg = {
@@ -135,71 +348,111 @@ bool tamper_detection_start(tamper_context_t *context) {
         .sample_rate = 1000,  /* 1kHz sampling */
         .temp_low_threshold = TEMP_THRESHOLD_LOW_C,
         .temp_high_threshold = TEMP_THRESHOLD_HIGH_C,
-        .continuous_mode = true
+        .continuous_mode = true,
+        .supply_scan = true
     };
     
     if (!iadc_init(&iadc_cfg)) {
         return false;
     }
     
-    /* Set initial measurements */
-    g_tamper_context.last_voltage_mv = VOLTAGE_NOMINAL_MV;
-    g_tamper_context.last_temp_c = TEMP_NOMINAL_C;
-    
     return true;
 }
 
 /**
- * @brief Check for tamper events
+ * @brief Wait for the first IADC temperature conversion without blocking
  */
-uint32_t check_tamper_events(tamper_context_t *context) {
-    uint32_t events = TAMPER_EVENT_NONE;
+boot_job_status_t tamper_warmup_step(void *ctx) {
+    (void)ctx;
+    
+    if (g_iadc_config.sample_rate == 0) {
+        return BOOT_JOB_DONE;  /* Monitoring not started: nothing to wait for */
+    }
     
-    /* In production: Read actual ACMP and IADC status registers */
+    /* In production: IADC0->STATUS & IADC_STATUS_SINGLEFIFODV */
+    if ((IADC0_STATUS & IADC_STATUS_SINGLEFIFODV) == 0) {
+        return BOOT_JOB_PENDING;
+    }
     
-    /* Check voltage levels using ACMP */
-    /* Simulated voltage check - in production, read ACMP->STATUS */
-    uint32_t current_voltage = VOLTAGE_NOMINAL_MV;
+    uint32_t code = IADC0_SINGLEFIFODATA & 0xFFFF;
+    g_tamper_context.last_temp_c = IADC_CODE_TO_TEMP(code);
     
-    if (current_voltage < g_acmp_config.low_threshold) {
-        events |= TAMPER_EVENT_VOLTAGE_LOW;
-        g_tamper_context.event_count++;
+    /* Out of window: the comparator interrupt carries the response */
+    if (code < (IADC0_CMPTHR & 0xFFFF) || code > (IADC0_CMPTHR >> 16)) {
+        return BOOT_JOB_FAILED;
     }
     
-    if (current_voltage > g_acmp_config.high_threshold) {
-        events |= TAMPER_EVENT_VOLTAGE_HIGH;
-        g_tamper_context.event_count++;
+    return BOOT_JOB_DONE;
+}
+
+/**
+ * @brief Latch events from an interrupt handler and respond
+ */
+RAMFUNC static void tamper_latch(uint32_t events) {
+    uint32_t bits = 0;
+    
+    if (events == TAMPER_EVENT_NONE) {
+        return;
     }
     
-    /* Check for rapid voltage changes (glitch detection) */
-    if (current_voltage != g_tamper_context.last_voltage_mv) {
-        int32_t voltage_delta = current_voltage - g_tamper_context.last_voltage_mv;
-        if (voltage_delta > 200 || voltage_delta < -200) {  /* >200mV change */
-            events |= TAMPER_EVENT_GLITCH;
-            g_tamper_context.event_count++;
-        }
+    /* Counted inline: __builtin_popcount is a libgcc call in flash on M33 */
+    for (uint32_t e = events; e != 0; e &= e - 1) {
+        bits++;
     }
     
-    g_tamper_context.last_voltage_mv = current_voltage;
+    /* Handlers may nest (ACMP preempting IADC), so update atomically */
+    __atomic_fetch_or(&g_pending_events, events, __ATOMIC_RELAXED);
+    __atomic_fetch_or(&g_tamper_context.event_flags, events, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&g_tamper_context.event_count, bits, __ATOMIC_RELAXED);
     
-    /* Check temperature using IADC */
-    /* Simulated temperature check - in production, read IADC->SINGLEDATA */
-    int32_t current_temp = TEMP_NOMINAL_C;
+    /* Whole response runs from RAM; the log (flash-resident attestation
+     * code) only after the secrets are gone. A reset-tier response does
+     * not return: the BURAM record carries the events to the next boot. */
+    execute_tamper_response(events);
     
-    if (current_temp < g_iadc_config.temp_low_threshold) {
-        events |= TAMPER_EVENT_TEMP_LOW;
-        g_tamper_context.event_count++;
+    (void)add_event_log_entry_id(TAMPER_LOG_EVENT_TYPE, events, g_tamper_string_id, NULL, 0);
+}
+
+/**
+ * @brief Evaluate one supply comparator
+ * @param flags Latched edge flags
+ * @param tripped Comparator output is in the fault state
+ * @param fault Event to raise while tripped
+ */
+RAMFUNC static uint32_t tamper_eval_comparator(uint32_t flags, bool tripped, uint32_t fault) {
+    uint32_t events = TAMPER_EVENT_NONE;
+    
+    /* Both edges before the handler ran: excursion shorter than IRQ latency */
+    if ((flags & (ACMP_IF_RISE | ACMP_IF_FALL)) == (ACMP_IF_RISE | ACMP_IF_FALL)) {
+        events |= TAMPER_EVENT_GLITCH;
     }
     
-    if (current_temp > g_iadc_config.temp_high_threshold) {
-        events |= TAMPER_EVENT_TEMP_HIGH;
-        g_tamper_context.event_count++;
+    if (tripped) {
+        events |= fault;
+    }
+    
+    return events;
+}
+
+/**
+ * @brief Get statistics of the most recent supply sample block
+ */
+bool tamper_get_window_stats(tamper_window_stats_t *stats) {
+    if (stats == NULL || g_window_stats.blocks == 0) {
+        return false;
     }
     
-    g_tamper_context.last_temp_c = current_temp;
+    *stats = g_window_stats;
     
-    /* Update context */
-    g_tamper_context.event_flags |= events;
+    return true;
+}
+
+/**
+ * @brief Check for tamper events
+ */
+RAMFUNC uint32_t check_tamper_events(tamper_context_t *context) {
+    /* Consume what the handlers latched; nothing is polled here */
+    uint32_t events = __atomic_exchange_n(&g_pending_events, TAMPER_EVENT_NONE, __ATOMIC_ACQ_REL);
     
     if (context != NULL) {
         *context = g_tamper_context;
@@ -209,94 +462,256 @@ uint32_t check_tamper_events(tamper_context_t *context) {
 }
 
 /**
- * @brief Execute anti-tamper response
+ * @brief Get the number of tamper events since tamper_detection_start()
  */
-void execute_tamper_response(uint32_t event_flags) {
-    /* Immediate response to tamper events */
-    
-    if (event_flags & TAMPER_EVENT_VOLTAGE_LOW) {
-        /* Voltage glitch detected - potential attack */
-        /* Actions:
-         * 1. Halt boot process immediately
-         * 2. Zeroize sensitive data in RAM
-         * 3. Lock debug interfaces
-         * 4. Log event to secure storage
-         */
-    }
-    
-    if (event_flags & TAMPER_EVENT_VOLTAGE_HIGH) {
-        /* Overvoltage detected */
-        /* Similar protective actions */
-    }
-    
-    if (event_flags & TAMPER_EVENT_GLITCH) {
-        /* Rapid voltage change - likely glitch attack */
-        /* This is critical - execute maximum response:
-         * 1. Immediate system halt
-         * 2. Disable all peripherals
-         * 3. Zeroize all RAM
-         * 4. Trigger hardware tamper response if available
-         */
-        
-        /* In production: Trigger EFR32 tamper response */
-        /* SMU->IF = SMU_IF_PPUSEC; */
+uint32_t tamper_event_count(void) {
+    return __atomic_load_n(&g_tamper_context.event_count, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Register a memory region to zeroize on tamper
+ */
+bool tamper_register_secret(void *base, uint32_t length) {
+    uint32_t count = g_secret_count;
+    
+    if (base == NULL || length == 0) {
+        return false;
+    }
+    
+    /* Registering again from a repeated init is a no-op */
+    for (uint32_t i = 0; i < count; i++) {
+        if (g_secret_regions[i].base == base && g_secret_regions[i].length == length) {
+            return true;
+        }
+    }
+    
+    if (count >= TAMPER_SECRET_REGION_MAX) {
+        return false;
+    }
+    
+    /* Entry is complete before a handler can see it */
+    g_secret_regions[count].base = base;
+    g_secret_regions[count].length = length;
+    __atomic_store_n(&g_secret_count, count + 1, __ATOMIC_RELEASE);
+    
+    return true;
+}
+
+/**
+ * @brief Select the reset-tier action
+ */
+void tamper_set_reset_action(tamper_reset_action_t action) {
+    g_reset_action = action;
+}
+
+/**
+ * @brief Get the response tier for a set of events
+ */
+RAMFUNC tamper_tier_t tamper_classify_events(uint32_t event_flags) {
+    if (event_flags & TAMPER_TIER_RESET_EVENTS) {
+        return TAMPER_TIER_RESET;
     }
     
-    if (event_flags & TAMPER_EVENT_TEMP_LOW) {
-        /* Extreme cold - possible freeze attack */
-        /* Monitor and prepare countermeasures */
+    if (event_flags & TAMPER_TIER_WIPE_EVENTS) {
+        return TAMPER_TIER_WIPE;
     }
     
-    if (event_flags & TAMPER_EVENT_TEMP_HIGH) {
-        /* Extreme heat - possible environmental attack */
-        /* Monitor and prepare countermeasures */
+    return TAMPER_TIER_NONE;
+}
+
+/**
+ * @brief Check the retained words for a valid tamper record
+ */
+RAMFUNC static bool tamper_record_intact(uint32_t magic, uint32_t event_flags,
+                                         uint32_t event_count, uint32_t check) {
+    return magic == TAMPER_RECORD_MAGIC &&
+           check == ~(magic ^ event_flags ^ event_count);
+}
+
+/**
+ * @brief Persist a compact tamper record to retained memory
+ */
+RAMFUNC static void tamper_persist_record(uint32_t event_flags) {
+    uint32_t count = g_tamper_context.event_count;
+    uint32_t flags = event_flags;
+    
+    /* Accumulate until cleared, but only onto a valid record: after
+     * power-on BURAM holds whatever the cells settled to */
+    if (tamper_record_intact(BURAM_RET[0], BURAM_RET[1], BURAM_RET[2], BURAM_RET[3])) {
+        flags |= BURAM_RET[1];
     }
     
-    if (event_flags & TAMPER_EVENT_CLOCK_ANOMALY) {
-        /* Clock glitching detected */
-        /* Halt immediately - this is a direct attack */
+    /* In production: BURAM->RET[n].REG, retained through reset and EM4 */
+    BURAM_RET[0] = TAMPER_RECORD_MAGIC;
+    BURAM_RET[1] = flags;
+    BURAM_RET[2] = count;
+    BURAM_RET[3] = ~(BURAM_RET[0] ^ BURAM_RET[1] ^ BURAM_RET[2]);
+}
+
+/**
+ * @brief Read the tamper record persisted before the last reset
+ */
+bool tamper_get_last_record(tamper_record_t *record) {
+    if (record == NULL) {
+        return false;
     }
     
-    /* If any critical event detected, halt system */
-    if (event_flags & (TAMPER_EVENT_GLITCH | TAMPER_EVENT_CLOCK_ANOMALY)) {
-        /* Enter infinite loop to prevent further execution */
-        while (1) {
-            /* Wait for watchdog reset */
-            __asm__ volatile ("nop");
-        }
+    record->magic = BURAM_RET[0];
+    record->event_flags = BURAM_RET[1];
+    record->event_count = BURAM_RET[2];
+    record->check = BURAM_RET[3];
+    
+    return tamper_record_intact(record->magic, record->event_flags,
+                                record->event_count, record->check);
+}
+
+/**
+ * @brief Clear the persisted tamper record
+ */
+void tamper_clear_record(void) {
+    for (uint32_t i = 0; i < TAMPER_RECORD_WORDS; i++) {
+        BURAM_RET[i] = 0;
+    }
+}
+
+/**
+ * @brief Leave the compromised state immediately
+ */
+RAMFUNC static void tamper_force_reset(void) {
+    if (g_reset_action == TAMPER_RESET_EM4) {
+        /* EM4: everything but BURAM/BURTC off until a wakeup pin or BURTC
+         * event; wakeup starts from the reset vector.
+         * In production:
+         * SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+         * for (i = 0; i < 4; i++) { EMU->EM4CTRL = EM4ENTRY(2); EMU->EM4CTRL = EM4ENTRY(3); }
+         * EMU->EM4CTRL = EM4ENTRY(2);
+         * __WFI();
+         * Falls back to SYSRESETREQ if EM4 entry is blocked. */
+    }
+
+#if defined(__ARM_FEATURE_CMSE)
+    __asm__ volatile ("dsb" ::: "memory");
+    SCB_AIRCR = AIRCR_VECTKEY | (SCB_AIRCR & AIRCR_PRIGROUP_MASK) | AIRCR_SYSRESETREQ;
+    __asm__ volatile ("dsb" ::: "memory");
+    
+    /* Reset takes a few cycles to assert */
+    while (1) {
+    }
+#else
+    /* Simulated: no reset on host builds */
+#endif
+}
+
+/**
+ * @brief Execute anti-tamper response
+ */
+RAMFUNC void execute_tamper_response(uint32_t event_flags) {
+    tamper_tier_t tier = tamper_classify_events(event_flags);
+    
+    if (tier == TAMPER_TIER_NONE) {
+        return;
+    }
+    
+    /* Secrets first: the cheapest action that defeats key extraction */
+    puf_session_zeroize();
+    
+    /* Large regions go through LDMA; every wipe is read back */
+    uint32_t count = __atomic_load_n(&g_secret_count, __ATOMIC_ACQUIRE);
+    bool wiped = true;
+    for (uint32_t i = 0; i < count; i++) {
+        wiped &= zeroize_region(g_secret_regions[i].base, g_secret_regions[i].length);
+    }
+    
+    /* Lock debug access until next reset */
+    /* In production: SE mailbox command to lock the debug interface */
+    
+    tamper_persist_record(event_flags);
+    
+    /* Glitch and clock attacks mean execution can no longer be trusted;
+     * a wipe that did not verify is treated the same way */
+    if (tier == TAMPER_TIER_RESET || !wiped) {
+        tamper_force_reset();
     }
 }
 
 /**
  * @brief ACMP interrupt handler for voltage glitch detection
  */
-void acmp_irq_handler(void) {
-    /* In production: Clear interrupt flags */
-    /* uint32_t flags = ACMP0->IF; */
-    /* ACMP0->IF = flags; */
-    
-    /* Check for edge events indicating voltage change */
-    /* if (flags & ACMP_IF_EDGE) { */
-        uint32_t events = check_tamper_events(&g_tamper_context);
-        if (events != TAMPER_EVENT_NONE) {
-            execute_tamper_response(events);
+RAMFUNC void acmp_irq_handler(void) {
+    uint32_t events = TAMPER_EVENT_NONE;
+    
+    /* Read and clear flags; in production: ACMPn->IF / ACMPn->IF_CLR */
+    uint32_t uv_flags = ACMP0_IF;
+    uint32_t ov_flags = ACMP1_IF;
+    ACMP0_IF = 0;
+    ACMP1_IF = 0;
+    
+    /* ACMP0 output low: supply below low_threshold */
+    if (uv_flags != 0) {
+        bool below = (ACMP0_STATUS & ACMP_STATUS_ACMPOUT) == 0;
+        events |= tamper_eval_comparator(uv_flags, below, TAMPER_EVENT_VOLTAGE_LOW);
+        if (below) {
+            g_tamper_context.last_voltage_mv = g_acmp_config.low_threshold;
         }
-    /* } */
+    }
+    
+    /* ACMP1 output high: supply above high_threshold */
+    if (ov_flags != 0) {
+        bool above = (ACMP1_STATUS & ACMP_STATUS_ACMPOUT) != 0;
+        events |= tamper_eval_comparator(ov_flags, above, TAMPER_EVENT_VOLTAGE_HIGH);
+        if (above) {
+            g_tamper_context.last_voltage_mv = g_acmp_config.high_threshold;
+        }
+    }
+    
+    tamper_latch(events);
 }
 
 /**
  * @brief IADC interrupt handler for temperature anomaly detection
  */
-void iadc_irq_handler(void) {
-    /* In production: Clear interrupt flags */
-    /* uint32_t flags = IADC0->IF; */
-    /* IADC0->IF = flags; */
-    
-    /* Check for threshold events */
-    /* if (flags & IADC_IF_SINGLECMP) { */
-        uint32_t events = check_tamper_events(&g_tamper_context);
-        if (events != TAMPER_EVENT_NONE) {
-            execute_tamper_response(events);
-        }
-    /* } */
+RAMFUNC void iadc_irq_handler(void) {
+    uint32_t events = TAMPER_EVENT_NONE;
+    
+    /* Read and clear flags; in production: IADC0->IF / IADC0->IF_CLR */
+    uint32_t flags = IADC0_IF;
+    IADC0_IF = 0;
+    
+    if ((flags & IADC_IF_SINGLECMP) == 0) {
+        return;
+    }
+    
+    /* The comparator already decided the sample is out of window; only
+     * the side needs resolving */
+    uint32_t code = IADC0_SINGLEFIFODATA & 0xFFFF;
+    int32_t temp = IADC_CODE_TO_TEMP(code);
+    
+    if (code < (IADC0_CMPTHR & 0xFFFF)) {
+        events |= TAMPER_EVENT_TEMP_LOW;
+    } else if (code > (IADC0_CMPTHR >> 16)) {
+        events |= TAMPER_EVENT_TEMP_HIGH;
+    }
+    
+    g_tamper_context.last_temp_c = temp;
+    
+    tamper_latch(events);
+}
+
+/**
+ * @brief LDMA half-buffer interrupt handler for supply samples
+ */
+RAMFUNC void iadc_dma_irq_handler(void) {
+    /* Read and clear flags; in production: LDMA->IF / LDMA->IF_CLR */
+    uint32_t flags = LDMA_IF;
+    LDMA_IF = flags & ~LDMA_IF_DONE(TAMPER_LDMA_CH);
+    
+    if ((flags & LDMA_IF_DONE(TAMPER_LDMA_CH)) == 0) {
+        return;
+    }
+    
+    /* DMA has moved on to the other half; this one is stable */
+    const volatile uint16_t *block = &g_supply_samples[g_supply_half * TAMPER_SAMPLE_BLOCK_SIZE];
+    g_supply_half ^= 1;
+    
+    tamper_latch(tamper_process_block(block, TAMPER_SAMPLE_BLOCK_SIZE));
 }
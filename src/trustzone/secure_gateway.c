@@ -0,0 +1,157 @@
+/**
+ * @file secure_gateway.c
+ * @brief Secure Gateway Call Dispatcher Implementation
+ * 
+ * Only the three entry points below carry SG veneers; every registered
+ * function is reached through the dispatch table, so adding a gateway
+ * never grows the NSC region. Request descriptors are read once into
+ * locals to avoid double-fetch races with the Non-Secure side.
+ */
+
+#include "secure_gateway.h"
+#include <stddef.h>
+#include <string.h>
+
+#define SG_RING_MASK    (SG_RING_SIZE - 1)
+
+/* Dispatch table indexed by function_id (NULL = not registered) */
+static secure_gateway_fn_t g_sg_table[TZ_MAX_GATEWAYS];
+
+/* Attached Non-Secure ring and Secure-side copy of its tail */
+static sg_request_ring_t *g_sg_ring = NULL;
+static uint32_t g_sg_ring_tail = 0;
+
+/**
+ * @brief Clear the dispatch table and detach any request ring
+ */
+void secure_gateway_reset(void) {
+    memset(g_sg_table, 0, sizeof(g_sg_table));
+    g_sg_ring = NULL;
+    g_sg_ring_tail = 0;
+}
+
+/**
+ * @brief Install a gateway handler in the dispatch table
+ */
+bool secure_gateway_bind(const secure_gateway_t *gateway) {
+    if (gateway == NULL || gateway->function_id >= TZ_MAX_GATEWAYS) {
+        return false;
+    }
+    
+    if (!gateway->enabled) {
+        return true;  /* Nothing to dispatch */
+    }
+    
+    if (gateway->handler == NULL || g_sg_table[gateway->function_id] != NULL) {
+        return false;  /* Missing handler or duplicate function_id */
+    }
+    
+    g_sg_table[gateway->function_id] = gateway->handler;
+    
+    return true;
+}
+
+/**
+ * @brief Validate arguments in place and run the handler
+ */
+static int32_t sg_dispatch(uint32_t function_id, uint32_t buffer, uint32_t length, uint32_t arg) {
+    if (function_id >= TZ_MAX_GATEWAYS) {
+        return SG_STATUS_INVALID_FUNCTION;
+    }
+    
+    secure_gateway_fn_t handler = g_sg_table[function_id];
+    if (handler == NULL) {
+        return SG_STATUS_INVALID_FUNCTION;
+    }
+    
+    /* Zero-length calls carry no buffer */
+    if (length == 0) {
+        return handler(NULL, 0, arg);
+    }
+    
+    if (buffer == 0 || is_range_secure(buffer, length)) {
+        return SG_STATUS_INVALID_ARGUMENT;
+    }
+    
+    return handler((void *)(uintptr_t)buffer, length, arg);
+}
+
+/**
+ * @brief Call one Secure function (NSC entry)
+ */
+SG_NSC_ENTRY int32_t secure_gateway_call(uint32_t function_id, void *buffer,
+                                         uint32_t length, uint32_t arg) {
+    return sg_dispatch(function_id, (uint32_t)(uintptr_t)buffer, length, arg);
+}
+
+/**
+ * @brief Attach the shared request ring (NSC entry)
+ */
+SG_NSC_ENTRY bool secure_gateway_attach_ring(sg_request_ring_t *ring) {
+    if (ring == NULL) {
+        g_sg_ring = NULL;
+        return true;
+    }
+    
+    /* The whole ring must be Non-Secure; it is written back in place */
+    if (is_range_secure((uint32_t)(uintptr_t)ring, sizeof(sg_request_ring_t))) {
+        return false;
+    }
+    
+    uint32_t head = ring->head;
+    uint32_t tail = ring->tail;
+    
+    if (head - tail > SG_RING_SIZE) {
+        return false;  /* Inconsistent indices */
+    }
+    
+    g_sg_ring_tail = tail;
+    g_sg_ring = ring;
+    
+    return true;
+}
+
+/**
+ * @brief Service all pending ring requests (NSC entry)
+ */
+SG_NSC_ENTRY uint32_t secure_gateway_process_ring(void) {
+    sg_request_ring_t *ring = g_sg_ring;
+    
+    if (ring == NULL) {
+        return 0;
+    }
+    
+    /* Snapshot head once; requests submitted meanwhile wait for next entry */
+    uint32_t head = ring->head;
+    uint32_t tail = g_sg_ring_tail;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    
+    if (head - tail > SG_RING_SIZE) {
+        /* Non-Secure side corrupted head: drop the batch, keep Secure tail */
+        return 0;
+    }
+    
+    uint32_t completed = 0;
+    
+    while (tail != head) {
+        volatile sg_request_t *req = &ring->requests[tail & SG_RING_MASK];
+        
+        /* Single fetch of each descriptor field (volatile: no re-reads) */
+        uint32_t function_id = req->function_id;
+        uint32_t buffer = req->buffer;
+        uint32_t length = req->length;
+        uint32_t arg = req->arg;
+        
+        req->result = sg_dispatch(function_id, buffer, length, arg);
+        
+        tail++;
+        completed++;
+    }
+    
+    /* Results are visible before the tail is published */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    g_sg_ring_tail = tail;
+    ring->tail = tail;
+    
+    return completed;
+}
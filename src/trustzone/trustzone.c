@@ -7,16 +7,201 @@
  */
 
 #include "trustzone.h"
+#include "secure_gateway.h"
 #include <string.h>
 
+#if defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE & 2)
+#include <arm_cmse.h>
+#define TZ_CMSE_SECURE      1
+#else
+#define TZ_CMSE_SECURE      0
+#endif
+
+#define TZ_TT_AVAILABLE     (TZ_CLASSIFY_USE_TT && TZ_CMSE_SECURE)
+
+#if TZ_CMSE_SECURE
+/* SAU registers */
+#define SAU_RNR             (*(volatile uint32_t *)0xE000EDD8UL)
+#define SAU_RBAR            (*(volatile uint32_t *)0xE000EDDCUL)
+#define SAU_RLAR            (*(volatile uint32_t *)0xE000EDE0UL)
+
+/* System control registers (Secure view and Non-Secure alias) */
+#define SCB_NSACR           (*(volatile uint32_t *)0xE000ED8CUL)
+#define FPU_FPCCR           (*(volatile uint32_t *)0xE000EF34UL)
+#define SCB_NS_VTOR         (*(volatile uint32_t *)0xE002ED08UL)
+
+/* Secure stack bounds from the linker script; weak so a script that does
+ * not define them still links, with stack painting and scrubbing off */
+extern uint32_t __StackLimit __attribute__((weak));
+#define TZ_STACK_LIMIT      ((volatile uint32_t *)&__StackLimit)
+#define TZ_STACK_KNOWN      (&__StackLimit != NULL)
+#else
+/* Simulated SAU registers for host builds */
+static volatile uint32_t SAU_RNR;
+static volatile uint32_t SAU_RBAR;
+static volatile uint32_t SAU_RLAR;
+
+/* Simulated secure stack for host builds */
+#define TZ_SIM_STACK_WORDS  256
+static volatile uint32_t g_sim_stack[TZ_SIM_STACK_WORDS];
+#define TZ_STACK_LIMIT      (&g_sim_stack[0])
+#define TZ_STACK_KNOWN      1
+#endif
+
+#define NSACR_CP10_CP11     (3UL << 10)   /* Non-Secure FPU access */
+#define FPCCR_ASPEN         (1UL << 31)
+#define FPCCR_LSPEN         (1UL << 30)
+#define FPCCR_LSPENS        (1UL << 29)   /* Lock LSPEN against Non-Secure writes */
+#define FPCCR_CLRONRET      (1UL << 28)
+#define FPCCR_TS            (1UL << 26)   /* FP context treated as Secure */
+
 /* SAU register definitions (simplified for demonstration) */
 #define SAU_CTRL_ENABLE     (1UL << 0)
 #define SAU_CTRL_ALLNS      (1UL << 1)
 
+/* Scratch capacity while building the classification table */
+#define TZ_BUILD_INTERVAL_MAX   (TZ_NS_INTERVAL_MAX * 2)
+
+/* Address interval [base, base + size) */
+typedef struct {
+    uint32_t base;
+    uint32_t size;
+} tz_interval_t;
+
 /* Global TrustZone configuration */
 static trustzone_config_t g_tz_config;
 static bool g_tz_initialized = false;
 
+/* Sorted, merged Non-Secure intervals; unused entries have size 0 */
+static tz_interval_t g_ns_intervals[TZ_NS_INTERVAL_MAX];
+
+/* Lowest stack word address painted by tz_stack_paint() */
+static volatile uint32_t *g_stack_paint_end = NULL;
+
+/**
+ * @brief Branch-free unsigned a < b (returns 1 or 0)
+ */
+static inline uint32_t tz_ct_lt(uint32_t a, uint32_t b) {
+    return (uint32_t)(((uint64_t)a - (uint64_t)b) >> 63);
+}
+
+/**
+ * @brief Remove a Secure region from the Non-Secure interval list
+ * @return false if the scratch list overflowed
+ */
+static bool tz_subtract_region(tz_interval_t *list, uint32_t *count, const sau_region_config_t *secure) {
+    uint64_t s_start = secure->start_address;
+    uint64_t s_end = secure->end_address;
+    uint32_t n = *count;
+    
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t start = list[i].base;
+        uint64_t end = start + list[i].size;
+        
+        if (s_end <= start || s_start >= end) {
+            continue;  /* No overlap */
+        }
+        
+        /* Keep the piece below the secure region in place */
+        list[i].size = (s_start > start) ? (uint32_t)(s_start - start) : 0;
+        
+        /* Append the piece above it */
+        if (s_end < end) {
+            if (*count >= TZ_BUILD_INTERVAL_MAX) {
+                return false;
+            }
+            list[*count].base = (uint32_t)s_end;
+            list[*count].size = (uint32_t)(end - s_end);
+            (*count)++;
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Build the Non-Secure classification table from the configuration
+ * 
+ * Runs once at init: collects enabled Non-Secure regions, carves out every
+ * Secure region (Secure wins on overlap, as with the SAU), then sorts and
+ * merges adjacent intervals.
+ */
+static bool tz_build_classification(const trustzone_config_t *config) {
+    const sau_region_config_t *regions[] = {
+        &config->flash_secure,
+        &config->flash_non_secure,
+        &config->ram_secure,
+        &config->ram_non_secure,
+        &config->peripheral_secure
+    };
+    const uint32_t region_count = sizeof(regions) / sizeof(regions[0]);
+    tz_interval_t list[TZ_BUILD_INTERVAL_MAX];
+    uint32_t count = 0;
+    
+    memset(g_ns_intervals, 0, sizeof(g_ns_intervals));
+    
+    for (uint32_t i = 0; i < region_count; i++) {
+        const sau_region_config_t *r = regions[i];
+        
+        if (r->enable && r->region_type == REGION_TYPE_NON_SECURE &&
+            r->end_address > r->start_address) {
+            list[count].base = r->start_address;
+            list[count].size = r->end_address - r->start_address;
+            count++;
+        }
+    }
+    
+    for (uint32_t i = 0; i < region_count; i++) {
+        const sau_region_config_t *r = regions[i];
+        
+        if (r->enable && r->region_type != REGION_TYPE_NON_SECURE &&
+            !tz_subtract_region(list, &count, r)) {
+            return false;
+        }
+    }
+    
+    /* Insertion sort by base address */
+    for (uint32_t i = 1; i < count; i++) {
+        tz_interval_t key = list[i];
+        uint32_t j = i;
+        
+        while (j > 0 && list[j - 1].base > key.base) {
+            list[j] = list[j - 1];
+            j--;
+        }
+        list[j] = key;
+    }
+    
+    /* Merge adjacent or overlapping intervals, dropping empty ones */
+    uint32_t out = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t end = (uint64_t)list[i].base + list[i].size;
+        
+        if (list[i].size == 0) {
+            continue;
+        }
+        
+        if (out > 0) {
+            tz_interval_t *prev = &g_ns_intervals[out - 1];
+            uint64_t prev_end = (uint64_t)prev->base + prev->size;
+            
+            if (list[i].base <= prev_end) {
+                if (end > prev_end) {
+                    prev->size = (uint32_t)(end - prev->base);
+                }
+                continue;
+            }
+        }
+        
+        if (out >= TZ_NS_INTERVAL_MAX) {
+            return false;  /* Table too small */
+        }
+        g_ns_intervals[out++] = list[i];
+    }
+    
+    return true;
+}
+
 /**
  * @brief Configure SAU region
  */
@@ -43,6 +228,29 @@ bool sau_configure_region(uint32_t region_number, const sau_region_config_t *con
     return true;
 }
 
+/**
+ * @brief Program SAU regions from precomputed words
+ */
+bool sau_apply_words(const sau_region_words_t *words, uint32_t count) {
+    if (words == NULL || count > SAU_REGION_MAX) {
+        return false;
+    }
+    
+    /* Disable every region, then write the blob back to back */
+    for (uint32_t i = 0; i < SAU_REGION_MAX; i++) {
+        SAU_RNR = i;
+        SAU_RLAR = 0;
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        SAU_RNR = words[i].rnr;
+        SAU_RBAR = words[i].rbar;
+        SAU_RLAR = words[i].rlar;
+    }
+    
+    return true;
+}
+
 /**
  * @brief Enable SAU
  */
@@ -57,16 +265,9 @@ bool sau_enable(void) {
 }
 
 /**
- * @brief Initialize TrustZone and configure SAU regions
+ * @brief Program SAU regions one at a time from the region configuration
  */
-bool trustzone_init(const trustzone_config_t *config) {
-    if (config == NULL || g_tz_initialized) {
-        return false;
-    }
-    
-    /* Store configuration */
-    memcpy(&g_tz_config, config, sizeof(trustzone_config_t));
-    
+static bool sau_configure_regions(const trustzone_config_t *config) {
     /* Configure Secure Flash region
      * Typically: 0x00000000 - 0x00040000 (256KB for bootloader and secure code)
      */
@@ -102,10 +303,55 @@ bool trustzone_init(const trustzone_config_t *config) {
         return false;
     }
     
-    /* Enable SAU */
-    if (!sau_enable()) {
+    return true;
+}
+
+/**
+ * @brief Build TrustZone RAM state from the configuration
+ * @param program_sau false on warm resume, where the SAU was restored already
+ */
+static bool tz_setup(const trustzone_config_t *config, bool program_sau) {
+    if (config == NULL || g_tz_initialized) {
+        return false;
+    }
+    
+    /* Start stack watermark tracking before boot work uses the stack */
+    tz_stack_paint();
+    
+    /* Store configuration */
+    memcpy(&g_tz_config, config, sizeof(trustzone_config_t));
+    
+    /* Precompute address classification for gateway argument checks */
+    if (!tz_build_classification(config)) {
+        return false;
+    }
+    
+    /* Install statically configured gateways in the dispatch table */
+    secure_gateway_reset();
+    if (config->gateway_count > TZ_MAX_GATEWAYS) {
         return false;
     }
+    for (uint32_t i = 0; i < config->gateway_count; i++) {
+        if (!secure_gateway_bind(&config->gateways[i])) {
+            return false;
+        }
+    }
+    
+    /* Program SAU: precomputed words in one burst, or per-region fallback */
+    if (program_sau) {
+        if (config->sau_words != NULL) {
+            if (!sau_apply_words(config->sau_words, config->sau_word_count)) {
+                return false;
+            }
+        } else if (!sau_configure_regions(config)) {
+            return false;
+        }
+        
+        /* Enable SAU */
+        if (!sau_enable()) {
+            return false;
+        }
+    }
     
     /* Configure interrupt target states
      * Critical interrupts should target Secure state
@@ -119,6 +365,43 @@ bool trustzone_init(const trustzone_config_t *config) {
     return true;
 }
 
+/**
+ * @brief Initialize TrustZone and configure SAU regions
+ */
+bool trustzone_init(const trustzone_config_t *config) {
+    return tz_setup(config, true);
+}
+
+/**
+ * @brief Rebuild TrustZone state after an EM4 warm resume
+ */
+bool trustzone_resume(const trustzone_config_t *config) {
+    return tz_setup(config, false);
+}
+
+/**
+ * @brief Drop the TrustZone RAM state ahead of EM4 entry
+ */
+void trustzone_suspend(void) {
+    secure_gateway_reset();
+    memset(g_ns_intervals, 0, sizeof(g_ns_intervals));
+    memset(&g_tz_config, 0, sizeof(g_tz_config));
+    g_tz_initialized = false;
+}
+
+/**
+ * @brief Get the SAU words programmed by trustzone_init()
+ */
+uint32_t trustzone_get_sau_words(const sau_region_words_t **words) {
+    if (words == NULL || !g_tz_initialized || g_tz_config.sau_words == NULL) {
+        return 0;
+    }
+    
+    *words = g_tz_config.sau_words;
+    
+    return g_tz_config.sau_word_count;
+}
+
 /**
  * @brief Register secure gateway function
  */
@@ -127,80 +410,215 @@ bool register_secure_gateway(const secure_gateway_t *gateway) {
         return false;
     }
     
-    if (g_tz_config.gateway_count >= 16) {
+    if (g_tz_config.gateway_count >= TZ_MAX_GATEWAYS) {
         return false;  /* Maximum gateways reached */
     }
     
+    if (!secure_gateway_bind(gateway)) {
+        return false;
+    }
+    
     /* Store gateway configuration */
     memcpy(&g_tz_config.gateways[g_tz_config.gateway_count], 
            gateway, sizeof(secure_gateway_t));
     
     g_tz_config.gateway_count++;
     
-    /* In production: Set up SG veneer in Non-Secure Callable region
-     * The gateway function must be in an NSC region and start with SG instruction
-     */
+    /* Handlers stay in Secure flash; only the dispatcher entry points
+     * need SG veneers in the Non-Secure Callable region */
     
     return true;
 }
 
 /**
- * @brief Transition to Non-Secure state
+ * @brief Read the current stack pointer
  */
-void transition_to_nonsecure(uint32_t ns_reset_handler, uint32_t ns_stack_pointer) {
-    /* Prepare for transition to Non-Secure state
-     * This is typically called after secure boot completes
-     */
+static inline __attribute__((always_inline)) volatile uint32_t *tz_current_sp(void) {
+#if TZ_CMSE_SECURE
+    uint32_t sp;
+    __asm volatile ("mov %0, sp" : "=r" (sp));
+    return (volatile uint32_t *)sp;
+#else
+    return &g_sim_stack[TZ_SIM_STACK_WORDS];
+#endif
+}
+
+/**
+ * @brief Paint the unused secure stack for watermark tracking
+ */
+void tz_stack_paint(void) {
+    volatile uint32_t *p = TZ_STACK_LIMIT;
+    volatile uint32_t *sp = tz_current_sp();
     
-    /* Set up Non-Secure stack pointer */
-    /* __TZ_set_MSP_NS(ns_stack_pointer); */
+    /* No stack bounds: leave unpainted, the high water then reads 0 */
+    if (!TZ_STACK_KNOWN) {
+        return;
+    }
+    
+    /* Leaf function: nothing below sp is live */
+    while (p < sp) {
+        *p++ = TZ_STACK_PAINT_PATTERN;
+    }
     
-    /* Set up Non-Secure reset handler */
-    /* __TZ_set_CONTROL_NS(0); */
+    g_stack_paint_end = sp;
+}
+
+/**
+ * @brief Find the lowest stack word overwritten since painting
+ */
+static volatile uint32_t *tz_stack_watermark(void) {
+    volatile uint32_t *p = TZ_STACK_LIMIT;
     
-    /* Clear any sensitive data from Secure world registers */
-    /* ... */
+    if (g_stack_paint_end == NULL) {
+        return p;  /* Never painted: assume the whole stack was used */
+    }
     
-    /* Jump to Non-Secure reset handler */
-    /* typedef void (*funcptr_NS)(void) __attribute__((cmse_nonsecure_call)); */
-    /* funcptr_NS fp_NS = (funcptr_NS)ns_reset_handler; */
-    /* fp_NS(); */
+    while (p < g_stack_paint_end && *p == TZ_STACK_PAINT_PATTERN) {
+        p++;
+    }
     
-    /* In production: Use proper CMSE (ARM Cortex-M Security Extensions) API
-     * to perform secure transition
-     */
+    return p;
+}
+
+/**
+ * @brief Get secure stack high-water usage
+ */
+uint32_t tz_stack_high_water(void) {
+    volatile uint32_t *mark = tz_stack_watermark();
+    
+    if (g_stack_paint_end == NULL) {
+        return 0;
+    }
+    
+    return (uint32_t)((g_stack_paint_end - mark) * sizeof(uint32_t));
+}
+
+/**
+ * @brief Zero the used secure stack below the current stack pointer
+ * 
+ * Only the range between the high-water mark and sp can hold stale
+ * secrets from finished calls; words still painted were never written.
+ */
+static void tz_scrub_stack(void) {
+    volatile uint32_t *p = tz_stack_watermark();
+    volatile uint32_t *sp = tz_current_sp();
+    
+    /* Without the limit there is no safe lower bound to clear down to */
+    if (!TZ_STACK_KNOWN) {
+        return;
+    }
+    
+    while (p < sp) {
+        *p++ = 0;
+    }
+}
+
+/**
+ * @brief Transition to Non-Secure state
+ */
+bool transition_to_nonsecure(uint32_t ns_vector_table) {
+    if (!g_tz_initialized || is_range_secure(ns_vector_table, 2 * sizeof(uint32_t))) {
+        return false;
+    }
+
+#if TZ_CMSE_SECURE
+    const volatile uint32_t *vectors = (const volatile uint32_t *)ns_vector_table;
+    uint32_t ns_stack_pointer = vectors[0];
+    uint32_t ns_reset_handler = vectors[1];
+    
+    if (is_address_secure(ns_reset_handler) || is_address_secure(ns_stack_pointer - 1)) {
+        return false;
+    }
+#endif
+    
+    /* Clear stale secrets from the part of the stack boot actually used */
+    tz_scrub_stack();
+
+#if TZ_CMSE_SECURE
+    /* Lazy FP: BLXNS reserves FP state with VLSTM and clears the registers
+     * without copying them unless Secure code used the FPU; TS keeps FP
+     * context Secure and LSPENS stops Non-Secure code re-enabling eager
+     * stacking. Non-Secure code gets its own FPU access via NSACR. */
+    FPU_FPCCR = (FPU_FPCCR | FPCCR_ASPEN | FPCCR_LSPEN | FPCCR_LSPENS |
+                 FPCCR_CLRONRET | FPCCR_TS);
+    SCB_NSACR |= NSACR_CP10_CP11;
+    
+    /* Non-Secure vector table, main stack and privileged thread mode */
+    SCB_NS_VTOR = ns_vector_table;
+    __asm volatile (
+        "msr msp_ns, %0     \n"
+        "msr control_ns, %1 \n"
+        "dsb                \n"
+        "isb                \n"
+        :: "r" (ns_stack_pointer), "r" (0u) : "memory"
+    );
+    
+    /* cmse_nonsecure_call clears caller-saved core registers before BLXNS */
+    typedef void __attribute__((cmse_nonsecure_call)) (*tz_ns_entry_t)(void);
+    tz_ns_entry_t ns_entry = (tz_ns_entry_t)cmse_nsfptr_create(ns_reset_handler);
+    ns_entry();
+    
+    /* Non-Secure reset handler must not return */
+    while (1);
+#else
+    return true;
+#endif
 }
 
 /**
  * @brief Check if address is in Secure region
+ * 
+ * Scans every table entry with no data-dependent branches, so timing does
+ * not reveal which region an address falls in.
  */
 bool is_address_secure(uint32_t address) {
     if (!g_tz_initialized) {
         return false;
     }
-    
-    /* Check against configured SAU regions */
-    
-    /* Check Secure Flash */
-    if (address >= g_tz_config.flash_secure.start_address &&
-        address < g_tz_config.flash_secure.end_address &&
-        g_tz_config.flash_secure.region_type == REGION_TYPE_SECURE) {
-        return true;
+
+#if TZ_TT_AVAILABLE
+    /* TT returns the SAU/IDAU attribution of the address */
+    cmse_address_info_t info = cmse_TT((void *)address);
+    return info.flags.secure != 0;
+#else
+    uint32_t non_secure = 0;
+    
+    for (uint32_t i = 0; i < TZ_NS_INTERVAL_MAX; i++) {
+        non_secure |= tz_ct_lt(address - g_ns_intervals[i].base, g_ns_intervals[i].size);
     }
     
-    /* Check Secure RAM */
-    if (address >= g_tz_config.ram_secure.start_address &&
-        address < g_tz_config.ram_secure.end_address &&
-        g_tz_config.ram_secure.region_type == REGION_TYPE_SECURE) {
-        return true;
+    return non_secure == 0;
+#endif
+}
+
+/**
+ * @brief Check if any part of an address range is Secure
+ * 
+ * Intervals are merged, so a fully Non-Secure range lies inside exactly
+ * one table entry.
+ */
+bool is_range_secure(uint32_t address, uint32_t length) {
+    if (!g_tz_initialized) {
+        return false;
     }
     
-    /* Check Secure Peripherals */
-    if (address >= g_tz_config.peripheral_secure.start_address &&
-        address < g_tz_config.peripheral_secure.end_address &&
-        g_tz_config.peripheral_secure.region_type == REGION_TYPE_SECURE) {
-        return true;
+    /* Zero-length checks the start address */
+    length += (uint32_t)(length == 0);
+
+#if TZ_TT_AVAILABLE
+    /* NULL unless the whole range is Non-Secure within one TT region */
+    return cmse_check_address_range((void *)address, length, CMSE_NONSECURE) == NULL;
+#else
+    uint32_t non_secure = 0;
+    
+    for (uint32_t i = 0; i < TZ_NS_INTERVAL_MAX; i++) {
+        uint32_t offset = address - g_ns_intervals[i].base;
+        uint32_t size = g_ns_intervals[i].size;
+        
+        /* offset < size && length <= size - offset */
+        non_secure |= tz_ct_lt(offset, size) & (tz_ct_lt(size - offset, length) ^ 1u);
     }
     
-    return false;
+    return non_secure == 0;
+#endif
 }
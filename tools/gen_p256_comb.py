@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Generate fixed-base comb tables for ECDSA P-256 verification.
+
+Emits a C source with the root public key and one comb table each for
+the curve generator G and the root key Q. Points are affine, with
+coordinates in the Montgomery domain (x * 2^256 mod p) as eight
+little-endian 32-bit limbs, matching src/crypto/ecdsa_p256.c.
+
+Table entry j - 1 (j = 1 .. 2^teeth - 1) holds
+    sum over set bits i of j of 2^(i * d) * P,   d = ceil(256 / teeth)
+
+Usage: gen_p256_comb.py [--teeth N] ROOT_PUBKEY_HEX OUTPUT_C
+"""
+
+import argparse
+import sys
+
+P = 0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF
+N = 0xFFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551
+B = 0x5AC635D8AA3A93E7B3EBBD55769886BC651D06B0CC53B0F63BCE3C3E27D2604B
+GX = 0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296
+GY = 0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5
+MONT_R = 1 << 256
+
+
+def on_curve(pt):
+    x, y = pt
+    return (y * y - (x * x * x - 3 * x + B)) % P == 0
+
+
+def point_add(p1, p2):
+    if p1 is None:
+        return p2
+    if p2 is None:
+        return p1
+    x1, y1 = p1
+    x2, y2 = p2
+    if x1 == x2:
+        if (y1 + y2) % P == 0:
+            return None
+        lam = (3 * x1 * x1 - 3) * pow(2 * y1, -1, P) % P
+    else:
+        lam = (y2 - y1) * pow(x2 - x1, -1, P) % P
+    x3 = (lam * lam - x1 - x2) % P
+    return (x3, (lam * (x1 - x3) - y1) % P)
+
+
+def point_mul(k, pt):
+    result = None
+    while k:
+        if k & 1:
+            result = point_add(result, pt)
+        pt = point_add(pt, pt)
+        k >>= 1
+    return result
+
+
+def comb_table(pt, teeth):
+    spacing = (256 + teeth - 1) // teeth
+    bases = [point_mul(1 << (i * spacing), pt) for i in range(teeth)]
+    table = []
+    for j in range(1, 1 << teeth):
+        acc = None
+        for i in range(teeth):
+            if j & (1 << i):
+                acc = point_add(acc, bases[i])
+        table.append(acc)
+    return table
+
+
+def limbs(value):
+    value = value * MONT_R % P
+    return ", ".join("0x%08X" % ((value >> (32 * i)) & 0xFFFFFFFF) for i in range(8))
+
+
+def read_pubkey(path):
+    with open(path) as f:
+        text = "".join(line.split("#", 1)[0].strip() for line in f)
+    raw = bytes.fromhex(text)
+    if len(raw) == 65 and raw[0] == 0x04:
+        raw = raw[1:]
+    if len(raw) != 64:
+        sys.exit("%s: expected an uncompressed P-256 point" % path)
+    pt = (int.from_bytes(raw[:32], "big"), int.from_bytes(raw[32:], "big"))
+    if pt[0] >= P or pt[1] >= P or not on_curve(pt):
+        sys.exit("%s: point is not on P-256" % path)
+    return raw, pt
+
+
+def emit_table(out, name, table):
+    out.append("const ecdsa_comb_point_t %s[ECDSA_COMB_POINTS] = {" % name)
+    for x, y in table:
+        out.append("    { { %s },\n      { %s } }," % (limbs(x), limbs(y)))
+    out.append("};")
+    out.append("")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--teeth", type=int, default=5)
+    parser.add_argument("pubkey")
+    parser.add_argument("output")
+    args = parser.parse_args()
+
+    if not 2 <= args.teeth <= 8:
+        sys.exit("--teeth must be in 2..8")
+
+    raw, root = read_pubkey(args.pubkey)
+
+    out = [
+        "/* Generated by tools/gen_p256_comb.py from %s - do not edit */" % args.pubkey,
+        "",
+        '#include "ecdsa_p256.h"',
+        "",
+        "#if ECDSA_COMB_TEETH != %d" % args.teeth,
+        '#error "Comb tables were generated for a different ECDSA_COMB_TEETH"',
+        "#endif",
+        "",
+        "const uint8_t g_ecdsa_root_pubkey[ECDSA_P256_PUBKEY_SIZE] = {",
+    ]
+    for i in range(0, 64, 16):
+        out.append("    " + ", ".join("0x%02X" % b for b in raw[i:i + 16]) + ",")
+    out.append("};")
+    out.append("")
+    emit_table(out, "g_ecdsa_comb_g", comb_table((GX, GY), args.teeth))
+    emit_table(out, "g_ecdsa_comb_root", comb_table(root, args.teeth))
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
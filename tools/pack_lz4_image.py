@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Pack a raw firmware image as an LZ4 block stream (FIRMWARE_FLAG_LZ4).
+
+Writes the slot payload that follows firmware_header_t:
+    image_lz4_ext_t { uint32 block_log2; uint32 compressed_size; }
+    per block: uint32 record (bit 31 = stored raw, bits 30:0 = length) + data
+
+Blocks are standard LZ4 block data whose matches may reach back into
+earlier blocks (offsets up to 64KB), since the bootloader decompresses
+into one contiguous buffer. Blocks that do not shrink are stored raw.
+For the header, image_size is the raw size and hash the SHA-256 of the
+raw image; both are printed.
+
+Usage: pack_lz4_image.py [--block-log2 N] INPUT_BIN OUTPUT_BIN
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+MIN_MATCH = 4
+LAST_LITERALS = 5      # LZ4: a block ends with at least 5 literals
+MF_LIMIT = 12          # LZ4: no match starts in the last 12 bytes
+MAX_OFFSET = 0xFFFF
+STORED = 1 << 31
+
+
+def put_length(out, n):
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def emit_sequence(out, literals, offset, match):
+    lit = len(literals)
+    token = min(lit, 15) << 4
+    if match:
+        token |= min(match - MIN_MATCH, 15)
+    out.append(token)
+    if lit >= 15:
+        put_length(out, lit - 15)
+    out += literals
+    if match:
+        out += struct.pack("<H", offset)
+        if match - MIN_MATCH >= 15:
+            put_length(out, match - MIN_MATCH - 15)
+
+
+def compress_block(data, start, end, table):
+    """Greedy LZ4 over data[start:end]; table maps 4-byte keys to positions."""
+    out = bytearray()
+    anchor = i = start
+    limit = end - MF_LIMIT
+
+    while i < limit:
+        key = data[i:i + 4]
+        cand = table.get(key)
+        table[key] = i
+        if cand is None or i - cand > MAX_OFFSET:
+            i += 1
+            continue
+
+        match = MIN_MATCH
+        max_match = end - LAST_LITERALS - i
+        while match < max_match and data[cand + match] == data[i + match]:
+            match += 1
+
+        emit_sequence(out, data[anchor:i], i - cand, match)
+        for j in range(i + 1, i + match, 4):
+            table[data[j:j + 4]] = j
+        i += match
+        anchor = i
+
+    emit_sequence(out, data[anchor:end], 0, 0)
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--block-log2", type=int, default=12)
+    parser.add_argument("input")
+    parser.add_argument("output")
+    args = parser.parse_args()
+
+    if not 10 <= args.block_log2 <= 16:
+        sys.exit("--block-log2 must be in 10..16")
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if not data:
+        sys.exit("%s: empty image" % args.input)
+
+    block = 1 << args.block_log2
+    table = {}
+    stream = bytearray()
+    for start in range(0, len(data), block):
+        end = min(start + block, len(data))
+        packed = compress_block(data, start, end, table)
+        if len(packed) < end - start:
+            stream += struct.pack("<I", len(packed)) + packed
+        else:
+            stream += struct.pack("<I", STORED | (end - start)) + data[start:end]
+
+    with open(args.output, "wb") as f:
+        f.write(struct.pack("<II", args.block_log2, len(stream)))
+        f.write(stream)
+
+    print("image_size      %d" % len(data))
+    print("compressed_size %d (%.1f%%)" % (len(stream), 100.0 * len(stream) / len(data)))
+    print("hash            %s" % hashlib.sha256(data).hexdigest())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Compute the signed digest of a firmware header, or fill in its signature.
+
+The header is the packed firmware_header_t at the start of the slot image:
+    uint32 magic, version, image_size, load_address, entry_point
+    uint8  signature[64]             (r || s, 32 bytes each, big-endian)
+    uint8  hash[32]
+    uint32 timestamp, flags
+
+The signature covers SHA-256 over every field but signature, in layout
+order, matching firmware_header_digest() in src/bootloader/secure_boot.c.
+
+Usage:
+    sign_header.py digest SLOT_BIN DIGEST_BIN
+    sign_header.py insert SLOT_BIN SIGNATURE_DER
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+HEADER_FORMAT = "<5I64s32sII"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+SIGNATURE_OFFSET = 5 * 4
+SIGNATURE_SIZE = 64
+FIRMWARE_IMAGE_MAGIC = 0x464D5750
+
+
+def header_digest(header):
+    tail = SIGNATURE_OFFSET + SIGNATURE_SIZE
+    return hashlib.sha256(header[:SIGNATURE_OFFSET] + header[tail:HEADER_SIZE]).digest()
+
+
+def der_length(der, pos):
+    n = der[pos]
+    pos += 1
+    if n & 0x80:
+        count = n & 0x7F
+        n = int.from_bytes(der[pos:pos + count], "big")
+        pos += count
+    return n, pos
+
+
+def der_to_raw(der):
+    """DER SEQUENCE { INTEGER r, INTEGER s } -> 64-byte r || s."""
+    if not der or der[0] != 0x30:
+        sys.exit("signature is not a DER SEQUENCE")
+    _, pos = der_length(der, 1)
+    out = b""
+    for _ in range(2):
+        if der[pos] != 0x02:
+            sys.exit("signature is not a DER SEQUENCE of INTEGERs")
+        n, pos = der_length(der, pos + 1)
+        value = int.from_bytes(der[pos:pos + n], "big")
+        pos += n
+        if value.bit_length() > 256:
+            sys.exit("signature component exceeds 256 bits")
+        out += value.to_bytes(32, "big")
+    return out
+
+
+def read_header(path):
+    with open(path, "rb") as f:
+        slot = bytearray(f.read())
+    if len(slot) < HEADER_SIZE:
+        sys.exit("%s: shorter than firmware_header_t (%d bytes)" % (path, HEADER_SIZE))
+    if struct.unpack_from("<I", slot, 0)[0] != FIRMWARE_IMAGE_MAGIC:
+        sys.exit("%s: bad firmware header magic" % path)
+    return slot
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("digest", help="write the 32-byte digest to sign")
+    p.add_argument("slot")
+    p.add_argument("output")
+    p = sub.add_parser("insert", help="write a DER signature into the header")
+    p.add_argument("slot")
+    p.add_argument("signature")
+    args = parser.parse_args()
+
+    slot = read_header(args.slot)
+
+    if args.command == "digest":
+        digest = header_digest(slot)
+        with open(args.output, "wb") as f:
+            f.write(digest)
+        print("header digest   %s" % digest.hex())
+        return
+
+    with open(args.signature, "rb") as f:
+        raw = der_to_raw(f.read())
+    slot[SIGNATURE_OFFSET:SIGNATURE_OFFSET + SIGNATURE_SIZE] = raw
+    with open(args.slot, "wb") as f:
+        f.write(slot)
+    print("signature       %s" % raw.hex())
+
+
+if __name__ == "__main__":
+    main()